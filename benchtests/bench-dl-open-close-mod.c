@@ -0,0 +1,51 @@
+/* Module for bench-dl-open-close.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+#include <string.h>
+
+/* A typical plugin: a few entry points which refer to each other and
+   to libc, so that the object has relocations and an initializer.  */
+
+static char *plugin_name;
+
+static void
+__attribute__ ((constructor))
+plugin_init (void)
+{
+  plugin_name = strdup ("bench-dl-open-close-mod");
+}
+
+static void
+__attribute__ ((destructor))
+plugin_fini (void)
+{
+  free (plugin_name);
+}
+
+const char *
+plugin_get_name (void)
+{
+  return plugin_name;
+}
+
+size_t
+plugin_name_length (void)
+{
+  return strlen (plugin_get_name ());
+}
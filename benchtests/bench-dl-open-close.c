@@ -0,0 +1,216 @@
+/* Benchmark dlopen and dlclose with many loaded objects.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "bench-timing.h"
+#include "json-lib.h"
+
+/* Measure the cost of dlopen and dlclose in a process which has many
+   objects loaded, like a plugin host.  The module given on the command
+   line is copied NUM_OBJECTS times into a temporary directory, so that
+   each copy is a separate object.  All copies are opened, then one
+   more copy is opened and closed repeatedly, then all copies are
+   closed.  This is done with RTLD_LOCAL and RTLD_GLOBAL.  */
+
+#define NUM_OBJECTS 1000
+#define NUM_CYCLES 1000
+
+static char *tmpdir;
+static unsigned int num_objects;
+
+static void
+cleanup (void)
+{
+  if (tmpdir == NULL)
+    return;
+  for (unsigned int i = 0; i <= num_objects; i++)
+    {
+      char path[strlen (tmpdir) + 32];
+      sprintf (path, "%s/mod%u.so", tmpdir, i);
+      unlink (path);
+    }
+  rmdir (tmpdir);
+}
+
+static void
+error_exit (const char *msg)
+{
+  fprintf (stderr, "error: %s\n", msg);
+  cleanup ();
+  exit (1);
+}
+
+/* Write NUM_OBJECTS + 1 copies of MODULE into TMPDIR.  */
+static void
+copy_module (const char *module)
+{
+  int fd = open (module, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat (fd, &st) != 0)
+    error_exit ("cannot open module");
+  char *data = malloc (st.st_size);
+  if (data == NULL || read (fd, data, st.st_size) != st.st_size)
+    error_exit ("cannot read module");
+  close (fd);
+
+  for (unsigned int i = 0; i <= num_objects; i++)
+    {
+      char path[strlen (tmpdir) + 32];
+      sprintf (path, "%s/mod%u.so", tmpdir, i);
+      fd = open (path, O_WRONLY | O_CREAT | O_TRUNC, 0755);
+      if (fd < 0 || write (fd, data, st.st_size) != st.st_size
+	  || close (fd) != 0)
+	error_exit ("cannot write module copy");
+    }
+  free (data);
+}
+
+static void *
+xdlopen (unsigned int i, int mode)
+{
+  char path[strlen (tmpdir) + 32];
+  sprintf (path, "%s/mod%u.so", tmpdir, i);
+  void *handle = dlopen (path, mode);
+  if (handle == NULL)
+    error_exit (dlerror ());
+  return handle;
+}
+
+typedef struct
+{
+  timing_t open_all;
+  timing_t open_close;
+  timing_t close_all;
+} dl_result;
+
+static void
+do_benchmark (int mode, dl_result *res)
+{
+  timing_t start, stop;
+  void **handles = malloc (num_objects * sizeof (void *));
+  if (handles == NULL)
+    error_exit ("out of memory");
+
+  TIMING_NOW (start);
+  for (unsigned int i = 0; i < num_objects; i++)
+    handles[i] = xdlopen (i, mode);
+  TIMING_NOW (stop);
+  TIMING_DIFF (res->open_all, start, stop);
+
+  TIMING_NOW (start);
+  for (unsigned int i = 0; i < NUM_CYCLES; i++)
+    dlclose (xdlopen (num_objects, mode));
+  TIMING_NOW (stop);
+  TIMING_DIFF (res->open_close, start, stop);
+
+  /* Close the objects in the reverse order, as a plugin host would
+     on shutdown.  */
+  TIMING_NOW (start);
+  for (unsigned int i = num_objects; i > 0; i--)
+    dlclose (handles[i - 1]);
+  TIMING_NOW (stop);
+  TIMING_DIFF (res->close_all, start, stop);
+
+  free (handles);
+}
+
+static void
+print_result (json_ctx_t *json_ctx, const char *prefix, dl_result *res)
+{
+  char s[100];
+
+  sprintf (s, "%s_open_time", prefix);
+  json_attr_double (json_ctx, s, (double) res->open_all / num_objects);
+  sprintf (s, "%s_open_close_time", prefix);
+  json_attr_double (json_ctx, s, (double) res->open_close / NUM_CYCLES);
+  sprintf (s, "%s_close_time", prefix);
+  json_attr_double (json_ctx, s, (double) res->close_all / num_objects);
+}
+
+static void
+usage (const char *name)
+{
+  fprintf (stderr, "%s: <module> [<number of objects>]\n", name);
+  exit (1);
+}
+
+int
+main (int argc, char **argv)
+{
+  if (argc < 2 || argc > 3)
+    usage (argv[0]);
+
+  num_objects = NUM_OBJECTS;
+  if (argc == 3)
+    {
+      long val = strtol (argv[2], NULL, 0);
+      if (val <= 0)
+	usage (argv[0]);
+      num_objects = val;
+    }
+
+  const char *dir = getenv ("TMPDIR");
+  if (dir == NULL || dir[0] == '\0')
+    dir = "/tmp";
+  char template[strlen (dir) + 32];
+  sprintf (template, "%s/bench-dl-XXXXXX", dir);
+  tmpdir = mkdtemp (template);
+  if (tmpdir == NULL)
+    error_exit ("cannot create temporary directory");
+  copy_module (argv[1]);
+
+  dl_result local, global;
+  do_benchmark (RTLD_NOW | RTLD_LOCAL, &local);
+  do_benchmark (RTLD_NOW | RTLD_GLOBAL, &global);
+
+  cleanup ();
+
+  json_ctx_t json_ctx;
+
+  json_init (&json_ctx, 0, stdout);
+
+  json_document_begin (&json_ctx);
+
+  json_attr_string (&json_ctx, "timing_type", TIMING_TYPE);
+
+  json_attr_object_begin (&json_ctx, "functions");
+
+  json_attr_object_begin (&json_ctx, "dlopen");
+
+  json_attr_object_begin (&json_ctx, "");
+  json_attr_double (&json_ctx, "objects", num_objects);
+
+  print_result (&json_ctx, "local", &local);
+  print_result (&json_ctx, "global", &global);
+
+  json_attr_object_end (&json_ctx);
+
+  json_attr_object_end (&json_ctx);
+
+  json_attr_object_end (&json_ctx);
+
+  json_document_end (&json_ctx);
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+/* Measure pthread_pool_memcpy_np against memcpy for very large copies.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The sizes range from 64 MiB to 4 GiB.  The measurement stops at the
+   first size for which the two buffers cannot be allocated.  The pool
+   has one worker per online CPU.  */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/sysinfo.h>
+
+#include "bench-timing.h"
+#include "json-lib.h"
+
+#define START_SIZE ((size_t) 64 * 1024 * 1024)
+#define END_SIZE ((size_t) 4 * 1024 * 1024 * 1024)
+
+static pthread_pool_t *pool;
+
+static void *
+pool_memcpy (void *dest, const void *src, size_t n)
+{
+  return pthread_pool_memcpy_np (pool, dest, src, n);
+}
+
+static const struct
+{
+  const char *name;
+  void *(*fn) (void *, const void *, size_t);
+} impls[] =
+  {
+    { "memcpy", memcpy },
+    { "pthread_pool_memcpy_np", pool_memcpy },
+  };
+
+static void
+do_one_test (json_ctx_t *json_ctx, void *(*fn) (void *, const void *, size_t),
+	     char *dst, const char *src, size_t len)
+{
+  size_t i, iters = len >= ((size_t) 1 << 30) ? 2 : 8;
+  timing_t start, stop, cur;
+
+  /* Warm up, so that the workers are running.  */
+  fn (dst, src, len);
+
+  TIMING_NOW (start);
+  for (i = 0; i < iters; ++i)
+    fn (dst, src, len);
+  TIMING_NOW (stop);
+
+  TIMING_DIFF (cur, start, stop);
+
+  json_element_double (json_ctx, (double) cur / (double) iters);
+}
+
+int
+main (void)
+{
+  json_ctx_t json_ctx;
+
+  if (pthread_pool_create_np (&pool, 0, NULL) != 0)
+    {
+      perror ("pthread_pool_create_np");
+      return 1;
+    }
+
+  json_init (&json_ctx, 0, stdout);
+
+  json_document_begin (&json_ctx);
+  json_attr_string (&json_ctx, "timing_type", TIMING_TYPE);
+
+  json_attr_object_begin (&json_ctx, "functions");
+  json_attr_object_begin (&json_ctx, "memcpy");
+  json_attr_string (&json_ctx, "bench-variant", "parallel");
+
+  json_array_begin (&json_ctx, "ifuncs");
+  for (size_t i = 0; i < sizeof (impls) / sizeof (impls[0]); i++)
+    json_element_string (&json_ctx, impls[i].name);
+  json_array_end (&json_ctx);
+
+  json_array_begin (&json_ctx, "results");
+  for (size_t len = START_SIZE; len <= END_SIZE; len <<= 1)
+    {
+      char *buf = mmap (NULL, 2 * len, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (buf == MAP_FAILED)
+	break;
+      /* Fault in both buffers before timing.  */
+      memset (buf, 0x5a, 2 * len);
+
+      json_element_object_begin (&json_ctx);
+      json_attr_uint (&json_ctx, "length", (double) len);
+      json_attr_uint (&json_ctx, "threads", (double) get_nprocs ());
+      json_array_begin (&json_ctx, "timings");
+      for (size_t i = 0; i < sizeof (impls) / sizeof (impls[0]); i++)
+	do_one_test (&json_ctx, impls[i].fn, buf + len, buf, len);
+      json_array_end (&json_ctx);
+      json_element_object_end (&json_ctx);
+
+      munmap (buf, 2 * len);
+    }
+  json_array_end (&json_ctx);
+
+  json_attr_object_end (&json_ctx);
+  json_attr_object_end (&json_ctx);
+  json_document_end (&json_ctx);
+
+  pthread_pool_destroy_np (pool);
+  return 0;
+}
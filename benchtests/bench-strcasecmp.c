@@ -17,6 +17,7 @@
    <https://www.gnu.org/licenses/>.  */
 
 #include <ctype.h>
+#include <stdbool.h>
 #define TEST_MAIN
 #define TEST_NAME "strcasecmp"
 #include "bench-string.h"
@@ -111,6 +112,86 @@ do_test (size_t align1, size_t align2, size_t len, int max_char,
   putchar ('\n');
 }
 
+/* Header names of HTTP requests, in the order of how often they occur
+   in a typical request.  A server looks up each received name in a
+   table of known names, so most comparisons fail within the first few
+   bytes and one runs to the end of the name.  */
+static const char *const header_names[] =
+{
+  "Host", "User-Agent", "Accept", "Accept-Encoding", "Accept-Language",
+  "Connection", "Referer", "Cookie", "Cache-Control", "Content-Type",
+  "Content-Length", "Origin", "If-Modified-Since", "If-None-Match",
+  "Upgrade-Insecure-Requests", "Authorization", "Sec-Fetch-Mode",
+  "Sec-Fetch-Site", "X-Forwarded-For", "X-Requested-With"
+};
+
+#define NUM_HEADERS (sizeof (header_names) / sizeof (header_names[0]))
+
+static void
+do_one_header_test (impl_t *impl, char **received, char **known)
+{
+  size_t i, j, k, iters = INNER_LOOP_ITERS / NUM_HEADERS;
+  timing_t start, stop, cur;
+
+  for (j = 0; j < NUM_HEADERS; ++j)
+    {
+      for (k = 0; k < NUM_HEADERS; ++k)
+	if (CALL (impl, received[j], known[k]) == 0)
+	  break;
+      if (k != j)
+	{
+	  error (0, 0, "Wrong result in function %s for %s", impl->name,
+		 received[j]);
+	  ret = 1;
+	  return;
+	}
+    }
+
+  TIMING_NOW (start);
+  for (i = 0; i < iters; ++i)
+    for (j = 0; j < NUM_HEADERS; ++j)
+      for (k = 0; CALL (impl, received[j], known[k]) != 0; ++k)
+	;
+  TIMING_NOW (stop);
+
+  TIMING_DIFF (cur, start, stop);
+
+  TIMING_PRINT_MEAN ((double) cur, (double) iters);
+}
+
+/* Look up the header names as sent by HTTP/1.1 clients, in their
+   usual capitalization, or in lower case as in HTTP/2, among the
+   known names in lower case.  */
+static void
+do_header_test (bool lower)
+{
+  char *received[NUM_HEADERS];
+  char *known[NUM_HEADERS];
+  char *p1 = (char *) buf1;
+  char *p2 = (char *) buf2;
+
+  for (size_t j = 0; j < NUM_HEADERS; ++j)
+    {
+      size_t len = strlen (header_names[j]);
+      received[j] = p1;
+      known[j] = p2;
+      for (size_t i = 0; i <= len; ++i)
+	{
+	  p1[i] = lower ? tolower (header_names[j][i]) : header_names[j][i];
+	  p2[i] = tolower (header_names[j][i]);
+	}
+      p1 += len + 1;
+      p2 += len + 1;
+    }
+
+  printf ("Header names, %-10s:", lower ? "lower case" : "mixed case");
+
+  FOR_EACH_IMPL (impl, 0)
+    do_one_header_test (impl, received, known);
+
+  putchar ('\n');
+}
+
 int
 test_main (void)
 {
@@ -150,6 +231,9 @@ test_main (void)
       do_test (2 * i, i, 8 << i, 254, -1);
     }
 
+  do_header_test (false);
+  do_header_test (true);
+
   return ret;
 }
 
@@ -144,6 +144,13 @@ test_main (void)
       do_test (i, 512, i);
     }
 
+  /* Sets too large for a single pcmpistri.  */
+  for (i = 32; i <= 240; i += 16)
+    {
+      do_test (0, 512, i);
+      do_test (i & 7, 512, i);
+    }
+
   for (i = 1; i < 8; ++i)
     {
       do_test (0, 16 << i, 4);
@@ -0,0 +1,367 @@
+/* Measure the memcpy and memset thresholds of an x86 processor.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <cpuid.h>
+#include <immintrin.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench-timing.h"
+
+/* Find the sizes at which the strategies used by memmove and memset
+   become faster than each other on this processor, and print them as
+   a profile for the dynamic linker (see glibc.cpu.x86_thresholds_file):
+
+     rep_movsb_threshold	REP MOVSB beats a vector loop.
+     rep_stosb_threshold	REP STOSB beats a vector loop.
+     non_temporal_threshold	Non-temporal stores beat a vector loop.
+     rep_movsb_stop_threshold	A vector loop beats REP MOVSB again.
+
+   Like bench-memcpy-large, every size is copied repeatedly between the
+   same two buffers, so data which fits into the cache stays there.
+   The loops use 32-byte vectors if the processor has AVX and 16-byte
+   vectors otherwise, which is the vector size of the memmove and memset
+   implementations selected on most processors.  A threshold is the
+   smallest size from which the second strategy is faster for all
+   larger sizes measured.  Thresholds which are not found are not
+   printed, so the dynamic linker keeps its default for them.
+
+   Usage: bench-x86-thresholds [<maximum size>]
+
+   The default maximum size for the non-temporal measurements is four
+   times the size of the last level cache, up to 256 MiB.  The output
+   is usually appended to the profile named by the
+   glibc.cpu.x86_thresholds_file tunable.  */
+
+#define SMALL_MIN 256
+#define SMALL_MAX (64 * 1024)
+#define LARGE_MIN (256 * 1024)
+#define DEFAULT_MAX (256 * 1024 * 1024)
+#define MAX_SIZES 64
+
+/* Number of bytes copied in each timed run, and number of runs of
+   which the fastest is used.  */
+#define RUN_BYTES (64 * 1024 * 1024)
+#define NUM_RUNS 7
+
+typedef void (*copy_fn) (char *, const char *, size_t);
+
+static void
+copy_vec16 (char *dst, const char *src, size_t n)
+{
+  for (size_t i = 0; i < n; i += 64)
+    {
+      __m128i a = _mm_loadu_si128 ((const __m128i *) (src + i));
+      __m128i b = _mm_loadu_si128 ((const __m128i *) (src + i + 16));
+      __m128i c = _mm_loadu_si128 ((const __m128i *) (src + i + 32));
+      __m128i d = _mm_loadu_si128 ((const __m128i *) (src + i + 48));
+      _mm_storeu_si128 ((__m128i *) (dst + i), a);
+      _mm_storeu_si128 ((__m128i *) (dst + i + 16), b);
+      _mm_storeu_si128 ((__m128i *) (dst + i + 32), c);
+      _mm_storeu_si128 ((__m128i *) (dst + i + 48), d);
+    }
+}
+
+static void
+copy_vec16_nt (char *dst, const char *src, size_t n)
+{
+  for (size_t i = 0; i < n; i += 64)
+    {
+      __m128i a = _mm_loadu_si128 ((const __m128i *) (src + i));
+      __m128i b = _mm_loadu_si128 ((const __m128i *) (src + i + 16));
+      __m128i c = _mm_loadu_si128 ((const __m128i *) (src + i + 32));
+      __m128i d = _mm_loadu_si128 ((const __m128i *) (src + i + 48));
+      _mm_stream_si128 ((__m128i *) (dst + i), a);
+      _mm_stream_si128 ((__m128i *) (dst + i + 16), b);
+      _mm_stream_si128 ((__m128i *) (dst + i + 32), c);
+      _mm_stream_si128 ((__m128i *) (dst + i + 48), d);
+    }
+  _mm_sfence ();
+}
+
+static void
+set_vec16 (char *dst, const char *src, size_t n)
+{
+  __m128i v = _mm_set1_epi8 (0x5a);
+  for (size_t i = 0; i < n; i += 64)
+    {
+      _mm_storeu_si128 ((__m128i *) (dst + i), v);
+      _mm_storeu_si128 ((__m128i *) (dst + i + 16), v);
+      _mm_storeu_si128 ((__m128i *) (dst + i + 32), v);
+      _mm_storeu_si128 ((__m128i *) (dst + i + 48), v);
+    }
+}
+
+__attribute__ ((target ("avx"))) static void
+copy_vec32 (char *dst, const char *src, size_t n)
+{
+  for (size_t i = 0; i < n; i += 128)
+    {
+      __m256i a = _mm256_loadu_si256 ((const __m256i *) (src + i));
+      __m256i b = _mm256_loadu_si256 ((const __m256i *) (src + i + 32));
+      __m256i c = _mm256_loadu_si256 ((const __m256i *) (src + i + 64));
+      __m256i d = _mm256_loadu_si256 ((const __m256i *) (src + i + 96));
+      _mm256_storeu_si256 ((__m256i *) (dst + i), a);
+      _mm256_storeu_si256 ((__m256i *) (dst + i + 32), b);
+      _mm256_storeu_si256 ((__m256i *) (dst + i + 64), c);
+      _mm256_storeu_si256 ((__m256i *) (dst + i + 96), d);
+    }
+  _mm256_zeroupper ();
+}
+
+__attribute__ ((target ("avx"))) static void
+copy_vec32_nt (char *dst, const char *src, size_t n)
+{
+  for (size_t i = 0; i < n; i += 128)
+    {
+      __m256i a = _mm256_loadu_si256 ((const __m256i *) (src + i));
+      __m256i b = _mm256_loadu_si256 ((const __m256i *) (src + i + 32));
+      __m256i c = _mm256_loadu_si256 ((const __m256i *) (src + i + 64));
+      __m256i d = _mm256_loadu_si256 ((const __m256i *) (src + i + 96));
+      _mm256_stream_si256 ((__m256i *) (dst + i), a);
+      _mm256_stream_si256 ((__m256i *) (dst + i + 32), b);
+      _mm256_stream_si256 ((__m256i *) (dst + i + 64), c);
+      _mm256_stream_si256 ((__m256i *) (dst + i + 96), d);
+    }
+  _mm_sfence ();
+  _mm256_zeroupper ();
+}
+
+__attribute__ ((target ("avx"))) static void
+set_vec32 (char *dst, const char *src, size_t n)
+{
+  __m256i v = _mm256_set1_epi8 (0x5a);
+  for (size_t i = 0; i < n; i += 128)
+    {
+      _mm256_storeu_si256 ((__m256i *) (dst + i), v);
+      _mm256_storeu_si256 ((__m256i *) (dst + i + 32), v);
+      _mm256_storeu_si256 ((__m256i *) (dst + i + 64), v);
+      _mm256_storeu_si256 ((__m256i *) (dst + i + 96), v);
+    }
+  _mm256_zeroupper ();
+}
+
+static void
+copy_rep_movsb (char *dst, const char *src, size_t n)
+{
+  asm volatile ("rep movsb" : "+D" (dst), "+S" (src), "+c" (n) : : "memory");
+}
+
+static void
+set_rep_stosb (char *dst, const char *src, size_t n)
+{
+  asm volatile ("rep stosb" : "+D" (dst), "+c" (n) : "a" (0x5a) : "memory");
+}
+
+static char *buf1;
+static char *buf2;
+
+/* Return the time of one call of FN with size N.  */
+static double
+measure (copy_fn fn, size_t n)
+{
+  size_t iters = RUN_BYTES / n;
+  if (iters == 0)
+    iters = 1;
+
+  timing_t best = 0;
+  for (int run = 0; run < NUM_RUNS; run++)
+    {
+      timing_t start, stop, diff;
+
+      /* Bring the buffers into the state of the timed calls.  */
+      fn (buf2, buf1, n);
+      TIMING_NOW (start);
+      for (size_t i = 0; i < iters; i++)
+	fn (buf2, buf1, n);
+      TIMING_NOW (stop);
+      TIMING_DIFF (diff, start, stop);
+      if (run == 0 || diff < best)
+	best = diff;
+    }
+  return (double) best / iters;
+}
+
+/* Return the smallest of the NSIZES sizes in SIZES from which FAST is
+   faster than SLOW for all larger sizes, or 0 if FAST is not faster
+   for the largest size.  */
+static size_t
+crossover (copy_fn slow, copy_fn fast, const size_t *sizes, int nsizes)
+{
+  size_t result = 0;
+  for (int i = nsizes - 1; i >= 0; i--)
+    {
+      double t_slow = measure (slow, sizes[i]);
+      double t_fast = measure (fast, sizes[i]);
+      fprintf (stderr, "%zu: %.1f %.1f\n", sizes[i], t_slow, t_fast);
+      if (t_fast >= t_slow)
+	break;
+      result = sizes[i];
+    }
+  return result;
+}
+
+/* Store the sizes from MIN to MAX in SIZES, in steps of half the next
+   lower power of two, so that all sizes are multiples of 4 vectors.
+   Return the number of sizes.  */
+static int
+make_sizes (size_t *sizes, size_t min, size_t max)
+{
+  int n = 0;
+  for (size_t size = min; size <= max && n < MAX_SIZES; n++)
+    {
+      sizes[n] = size;
+      size_t pow2 = (size_t) 1 << (63 - __builtin_clzl (size));
+      size += pow2 / 2;
+    }
+  return n;
+}
+
+/* Print the "cpu" line of the profile, with the vendor, family and
+   model computed like the dynamic linker does.  */
+static int
+print_cpu (void)
+{
+  unsigned int eax, ebx, ecx, edx;
+  char vendor[13];
+
+  __cpuid (0, eax, ebx, ecx, edx);
+  memcpy (vendor, &ebx, 4);
+  memcpy (vendor + 4, &edx, 4);
+  memcpy (vendor + 8, &ecx, 4);
+  vendor[12] = '\0';
+
+  __cpuid (1, eax, ebx, ecx, edx);
+  unsigned int family = (eax >> 8) & 0x0f;
+  unsigned int model = (eax >> 4) & 0x0f;
+  unsigned int extended_model = (eax >> 12) & 0xf0;
+  unsigned int stepping = eax & 0x0f;
+  if (family == 0x0f)
+    {
+      family += (eax >> 20) & 0xff;
+      model += extended_model;
+    }
+
+  const char *name;
+  if (strcmp (vendor, "GenuineIntel") == 0)
+    {
+      name = "intel";
+      if (family == 0x06)
+	model += extended_model;
+    }
+  else if (strcmp (vendor, "AuthenticAMD") == 0
+	   || strcmp (vendor, "HygonGenuine") == 0)
+    name = "amd";
+  else if (strcmp (vendor, "CentaurHauls") == 0
+	   || strcmp (vendor, "  Shanghai  ") == 0)
+    {
+      name = "zhaoxin";
+      model += extended_model;
+    }
+  else
+    {
+      fprintf (stderr, "error: unsupported processor vendor %s\n", vendor);
+      return 1;
+    }
+
+  printf ("# %s family %#x model %#x stepping %u.\n", vendor, family,
+	  model, stepping);
+  printf ("cpu %s %#x %#x\n", name, family, model);
+  return 0;
+}
+
+int
+main (int argc, char **argv)
+{
+  size_t max_size;
+  if (argc > 2)
+    {
+      fprintf (stderr, "usage: %s [<maximum size>]\n", argv[0]);
+      return 1;
+    }
+  else if (argc == 2)
+    max_size = strtoul (argv[1], NULL, 0);
+  else
+    {
+      long int cache = sysconf (_SC_LEVEL3_CACHE_SIZE);
+      if (cache <= 0)
+	cache = sysconf (_SC_LEVEL2_CACHE_SIZE);
+      max_size = cache > 0 ? 4 * cache : DEFAULT_MAX;
+      if (max_size > DEFAULT_MAX)
+	max_size = DEFAULT_MAX;
+    }
+  if (max_size < 2 * LARGE_MIN)
+    max_size = 2 * LARGE_MIN;
+
+  __builtin_cpu_init ();
+  size_t vec_size = __builtin_cpu_supports ("avx") ? 32 : 16;
+  copy_fn copy_vec = vec_size == 32 ? copy_vec32 : copy_vec16;
+  copy_fn copy_vec_nt = vec_size == 32 ? copy_vec32_nt : copy_vec16_nt;
+  copy_fn set_vec = vec_size == 32 ? set_vec32 : set_vec16;
+
+  buf1 = aligned_alloc (4096, max_size);
+  buf2 = aligned_alloc (4096, max_size);
+  if (buf1 == NULL || buf2 == NULL)
+    {
+      fprintf (stderr, "error: cannot allocate 2 * %zu bytes\n", max_size);
+      return 1;
+    }
+  memset (buf1, 0xa5, max_size);
+  memset (buf2, 0x5a, max_size);
+
+  if (print_cpu () != 0)
+    return 1;
+
+  size_t small_sizes[MAX_SIZES];
+  size_t large_sizes[MAX_SIZES];
+  int nsmall = make_sizes (small_sizes, SMALL_MIN, SMALL_MAX);
+  int nlarge = make_sizes (large_sizes, LARGE_MIN, max_size);
+
+  /* The dynamic linker ignores a REP MOVSB threshold which is not
+     larger than 8 vectors.  */
+  fprintf (stderr, "REP MOVSB, %zu-byte vectors:\n", vec_size);
+  size_t rep_movsb = crossover (copy_vec, copy_rep_movsb, small_sizes,
+				nsmall);
+  if (rep_movsb > 8 * vec_size)
+    printf ("rep_movsb_threshold %zu\n", rep_movsb);
+
+  fprintf (stderr, "REP STOSB, %zu-byte vectors:\n", vec_size);
+  size_t rep_stosb = crossover (set_vec, set_rep_stosb, small_sizes, nsmall);
+  if (rep_stosb != 0)
+    printf ("rep_stosb_threshold %zu\n", rep_stosb);
+
+  fprintf (stderr, "non-temporal stores, %zu-byte vectors:\n", vec_size);
+  size_t non_temporal = crossover (copy_vec, copy_vec_nt, large_sizes,
+				   nlarge);
+  if (non_temporal != 0)
+    printf ("non_temporal_threshold %#zx\n", non_temporal);
+
+  if (rep_movsb != 0)
+    {
+      fprintf (stderr, "%zu-byte vectors, REP MOVSB:\n", vec_size);
+      size_t stop = crossover (copy_rep_movsb, copy_vec, large_sizes,
+			       nlarge);
+      if (stop != 0 && (non_temporal == 0 || stop < non_temporal))
+	printf ("rep_movsb_stop_threshold %#zx\n", stop);
+    }
+
+  free (buf1);
+  free (buf2);
+  return 0;
+}
@@ -484,6 +484,55 @@ enum
 			      * sizeof (struct cache_extension_section)))
   };
 
+/* Build the contents of the cache_extension_tag_name_index section for
+   the sorted list of entries.  Store its size in *SIZE.  */
+static struct cache_name_index *
+build_name_index (uint32_t *size)
+{
+  /* Keep the load factor at or below one half.  */
+  uint32_t nnames = 0;
+  struct cache_entry *entry;
+  for (entry = entries; entry != NULL; entry = entry->next)
+    if (entry->next == NULL
+	|| _dl_cache_libcmp (entry->lib->string,
+			     entry->next->lib->string) != 0)
+      ++nnames;
+  uint32_t nslots = 16;
+  while (nslots < 2 * nnames)
+    nslots *= 2;
+
+  *size = (sizeof (struct cache_name_index)
+	   + nslots * sizeof (struct cache_name_index_slot));
+  struct cache_name_index *index = xmalloc (*size);
+  index->nslots = nslots;
+  for (uint32_t i = 0; i < nslots; ++i)
+    {
+      index->slots[i].hash = 0;
+      index->slots[i].first = UINT32_MAX;
+      index->slots[i].last = UINT32_MAX;
+    }
+
+  uint32_t first = 0;
+  uint32_t idx = 0;
+  for (entry = entries; entry != NULL; entry = entry->next, ++idx)
+    if (entry->next == NULL
+	|| _dl_cache_libcmp (entry->lib->string,
+			     entry->next->lib->string) != 0)
+      {
+	/* ENTRY is the last one with its name.  */
+	uint32_t hash = dl_cache_name_hash (entry->lib->string);
+	uint32_t i = hash & (nslots - 1);
+	while (index->slots[i].first != UINT32_MAX)
+	  i = (i + 1) & (nslots - 1);
+	index->slots[i].hash = hash;
+	index->slots[i].first = first;
+	index->slots[i].last = idx;
+	first = idx + 1;
+      }
+
+  return index;
+}
+
 /* Write the cache extensions to FD.  The string table is shifted by
    STRING_TABLE_OFFSET.  The extension directory is assumed to be
    located at CACHE_EXTENSION_OFFSET.  assign_glibc_hwcaps_indices
@@ -503,15 +552,16 @@ write_extensions (int fd, uint32_t str_offset,
     if (p->used)
       hwcaps_array[p->section_index] = str_offset + p->name->offset;
 
-  /* This is the offset of the generator string.  */
-  uint32_t generator_offset = hwcaps_offset;
+  /* The name index follows the hwcaps subdirectories.  */
+  uint32_t name_index_size;
+  struct cache_name_index *name_index = build_name_index (&name_index_size);
+  uint32_t name_index_offset = hwcaps_offset + hwcaps_size;
   if (hwcaps_count == 0)
     /* There is no section for the hwcaps subdirectories.  */
-    generator_offset -= sizeof (struct cache_extension_section);
-  else
-    /* The string table indices for the hwcaps subdirectories shift
-       the generator string backwards.  */
-    generator_offset += hwcaps_size;
+    name_index_offset -= sizeof (struct cache_extension_section);
+
+  /* This is the offset of the generator string.  */
+  uint32_t generator_offset = name_index_offset + name_index_size;
 
   struct cache_extension *ext = xmalloc (cache_extension_size);
   ext->magic = cache_extension_magic;
@@ -535,6 +585,12 @@ write_extensions (int fd, uint32_t str_offset,
       ext->sections[xid].size = hwcaps_size;
     }
 
+  ++xid;
+  ext->sections[xid].tag = cache_extension_tag_name_index;
+  ext->sections[xid].flags = 0;
+  ext->sections[xid].offset = name_index_offset;
+  ext->sections[xid].size = name_index_size;
+
   ++xid;
   ext->count = xid;
   assert (xid <= cache_extension_count);
@@ -543,9 +599,11 @@ write_extensions (int fd, uint32_t str_offset,
 		     + xid * sizeof (struct cache_extension_section));
   if (write (fd, ext, ext_size) != ext_size
       || write (fd, hwcaps_array, hwcaps_size) != hwcaps_size
+      || write (fd, name_index, name_index_size) != name_index_size
       || write (fd, generator, strlen (generator)) != strlen (generator))
     error (EXIT_FAILURE, errno, _("Writing of cache extension data failed"));
 
+  free (name_index);
   free (hwcaps_array);
   free (ext);
 }
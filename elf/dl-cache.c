@@ -36,6 +36,9 @@ static struct cache_file *cache;
 static struct cache_file_new *cache_new;
 static size_t cachesize;
 
+/* The cache_extension_tag_name_index section of cache_new, or NULL.  */
+static const struct cache_name_index *cache_name_index;
+
 #ifdef SHARED
 /* This is used to cache the priorities of glibc-hwcaps
    subdirectories.  The elements of _dl_cache_priorities correspond to
@@ -195,11 +198,12 @@ _dl_cache_file_entry (const struct file_entry *libs, size_t entry_size,
    The first matching entry in the table is returned.  It is important
    to use the same algorithm as used while generating the cache file.
    STRING_TABLE_SIZE indicates the maximum offset in STRING_TABLE at
-   which data is mapped; it is not exact.  */
+   which data is mapped; it is not exact.  If NAME_INDEX is not NULL,
+   it is used to find the entries for NAME without a binary search.  */
 static const char *
 search_cache (const char *string_table, uint32_t string_table_size,
 	      struct file_entry *libs, uint32_t nlibs, uint32_t entry_size,
-	      const char *name)
+	      const struct cache_name_index *name_index, const char *name)
 {
   /* Used by the HWCAP check in the struct file_entry_new case.  */
   uint64_t platform = _dl_string_platform (GLRO (dl_platform));
@@ -217,6 +221,34 @@ search_cache (const char *string_table, uint32_t string_table_size,
   uint32_t best_priority = 0;
 #endif
 
+  if (name_index != NULL)
+    {
+      /* Limit the binary search below to the entries with the name.
+	 An unused slot means that there are none.  */
+      uint32_t mask = name_index->nslots - 1;
+      uint32_t hash = dl_cache_name_hash (name);
+      for (uint32_t i = 0; i <= mask; ++i)
+	{
+	  const struct cache_name_index_slot *slot
+	    = &name_index->slots[(hash + i) & mask];
+	  if (slot->first == UINT32_MAX)
+	    return NULL;
+	  if (slot->hash != hash
+	      || slot->first > slot->last
+	      || slot->last >= nlibs)
+	    continue;
+	  uint32_t key = _dl_cache_file_entry (libs, entry_size,
+					       slot->first)->key;
+	  if (_dl_cache_verify_ptr (key, string_table_size)
+	      && _dl_cache_libcmp (name, string_table + key) == 0)
+	    {
+	      left = slot->first;
+	      right = slot->last;
+	      break;
+	    }
+	}
+    }
+
   while (left <= right)
     {
       int middle = (left + right) / 2;
@@ -475,6 +507,14 @@ _dl_load_cache_lookup (const char *name)
 	}
 
       assert (cache != NULL);
+
+      if (cache != (void *) -1 && cache_new != (void *) -1)
+	{
+	  struct cache_extension_all_loaded ext;
+	  if (cache_extension_load (cache_new, cache, cachesize, &ext))
+	    cache_name_index
+	      = ext.sections[cache_extension_tag_name_index].base;
+	}
     }
 
   if (cache == (void *) -1)
@@ -487,7 +527,8 @@ _dl_load_cache_lookup (const char *name)
       const char *string_table = (const char *) cache_new;
       best = search_cache (string_table, cachesize,
 			   &cache_new->libs[0].entry, cache_new->nlibs,
-			   sizeof (cache_new->libs[0]), name);
+			   sizeof (cache_new->libs[0]), cache_name_index,
+			   name);
     }
   else
     {
@@ -496,7 +537,7 @@ _dl_load_cache_lookup (const char *name)
 	= (const char *) cache + cachesize - string_table;
       best = search_cache (string_table, string_table_size,
 			   &cache->libs[0], cache->nlibs,
-			   sizeof (cache->libs[0]), name);
+			   sizeof (cache->libs[0]), NULL, name);
     }
 
   /* Print our result if wanted.  */
@@ -529,6 +570,7 @@ _dl_unload_cache (void)
     {
       __munmap (cache, cachesize);
       cache = NULL;
+      cache_name_index = NULL;
     }
 #ifdef SHARED
   /* This marks the glibc_hwcaps_priorities array as out-of-date.  */
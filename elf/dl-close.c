@@ -80,6 +80,7 @@ remove_slotinfo (size_t idx, struct dtv_slotinfo_list *listp, size_t disp,
 	  /* Mark the entry as unused.  These can be read concurrently.  */
 	  atomic_store_relaxed (&listp->slotinfo[idx - disp].gen,
 				GL(dl_tls_generation) + 1);
+	  atomic_store_relaxed (&listp->gen, GL(dl_tls_generation) + 1);
 	  atomic_store_relaxed (&listp->slotinfo[idx - disp].map, NULL);
 	}
 
@@ -167,8 +168,6 @@ _dl_close_worker (struct link_map *map, bool force)
 
   bool any_tls = false;
   const unsigned int nloaded = ns->_ns_nloaded;
-  char used[nloaded];
-  char done[nloaded];
   struct link_map *maps[nloaded];
 
   /* Run over the list and assign indexes to the link maps and enter
@@ -176,6 +175,8 @@ _dl_close_worker (struct link_map *map, bool force)
   int idx = 0;
   for (struct link_map *l = ns->_ns_loaded; l != NULL; l = l->l_next)
     {
+      l->l_map_used = 0;
+      l->l_map_done = 0;
       l->l_idx = idx;
       maps[idx] = l;
       ++idx;
@@ -183,17 +184,13 @@ _dl_close_worker (struct link_map *map, bool force)
     }
   assert (idx == nloaded);
 
-  /* Prepare the bitmaps.  */
-  memset (used, '\0', sizeof (used));
-  memset (done, '\0', sizeof (done));
-
   /* Keep track of the lowest index link map we have covered already.  */
   int done_index = -1;
   while (++done_index < nloaded)
     {
       struct link_map *l = maps[done_index];
 
-      if (done[done_index])
+      if (l->l_map_done)
 	/* Already handled.  */
 	continue;
 
@@ -204,12 +201,12 @@ _dl_close_worker (struct link_map *map, bool force)
 	  /* See CONCURRENCY NOTES in cxa_thread_atexit_impl.c to know why
 	     acquire is sufficient and correct.  */
 	  && atomic_load_acquire (&l->l_tls_dtor_count) == 0
-	  && !used[done_index])
+	  && !l->l_map_used)
 	continue;
 
       /* We need this object and we handle it now.  */
-      done[done_index] = 1;
-      used[done_index] = 1;
+      l->l_map_done = 1;
+      l->l_map_used = 1;
       /* Signal the object is still needed.  */
       l->l_idx = IDX_STILL_USED;
 
@@ -225,9 +222,9 @@ _dl_close_worker (struct link_map *map, bool force)
 		{
 		  assert ((*lp)->l_idx >= 0 && (*lp)->l_idx < nloaded);
 
-		  if (!used[(*lp)->l_idx])
+		  if (!(*lp)->l_map_used)
 		    {
-		      used[(*lp)->l_idx] = 1;
+		      (*lp)->l_map_used = 1;
 		      /* If we marked a new object as used, and we've
 			 already processed it, then we need to go back
 			 and process again from that point forward to
@@ -250,9 +247,9 @@ _dl_close_worker (struct link_map *map, bool force)
 	      {
 		assert (jmap->l_idx >= 0 && jmap->l_idx < nloaded);
 
-		if (!used[jmap->l_idx])
+		if (!jmap->l_map_used)
 		  {
-		    used[jmap->l_idx] = 1;
+		    jmap->l_map_used = 1;
 		    if (jmap->l_idx - 1 < done_index)
 		      done_index = jmap->l_idx - 1;
 		  }
@@ -260,17 +257,16 @@ _dl_close_worker (struct link_map *map, bool force)
 	  }
     }
 
-  /* Sort the entries.  We can skip looking for the binary itself which is
-     at the front of the search list for the main namespace.  */
-  _dl_sort_maps (maps + (nsid == LM_ID_BASE), nloaded - (nsid == LM_ID_BASE),
-		 used + (nsid == LM_ID_BASE), true);
+  /* Sort the entries.  The binary itself, which is at the front of the
+     search list for the main namespace, is kept there.  */
+  _dl_sort_maps (maps, nloaded, (nsid == LM_ID_BASE), true);
 
   /* Call all termination functions at once.  */
 #ifdef SHARED
   bool do_audit = GLRO(dl_naudit) > 0 && !ns->_ns_loaded->l_auditing;
 #endif
   bool unload_any = false;
-  bool scope_mem_left = false;
+  bool scope_retired = false;
   unsigned int unload_global = 0;
   unsigned int first_loaded = ~0;
   for (unsigned int i = 0; i < nloaded; ++i)
@@ -280,7 +276,7 @@ _dl_close_worker (struct link_map *map, bool force)
       /* All elements must be in the same namespace.  */
       assert (imap->l_ns == nsid);
 
-      if (!used[i])
+      if (!imap->l_map_used)
 	{
 	  assert (imap->l_type == lt_loaded && !imap->l_nodelete_active);
 
@@ -334,7 +330,7 @@ _dl_close_worker (struct link_map *map, bool force)
 	  if (i < first_loaded)
 	    first_loaded = i;
 	}
-      /* Else used[i].  */
+      /* Else imap->l_map_used.  */
       else if (imap->l_type == lt_loaded)
 	{
 	  struct r_scope_elem *new_list = NULL;
@@ -442,16 +438,15 @@ _dl_close_worker (struct link_map *map, bool force)
 
 	      imap->l_scope = newp;
 
-	      /* No user anymore, we can free it now.  */
+	      /* No user anymore, we can free it now.  The old scope
+		 refers to objects which are unloaded below, which
+		 therefore have to wait for the threads using it.  */
 	      if (old != imap->l_scope_mem)
-		{
-		  if (_dl_scope_free (old))
-		    /* If _dl_scope_free used THREAD_GSCOPE_WAIT (),
-		       no need to repeat it.  */
-		    scope_mem_left = false;
-		}
+		/* If _dl_scope_free used THREAD_GSCOPE_WAIT (), no need
+		   to repeat it.  */
+		scope_retired = !_dl_scope_free (old);
 	      else
-		scope_mem_left = true;
+		scope_retired = true;
 
 	      imap->l_scope_max = new_size;
 	    }
@@ -531,13 +526,17 @@ _dl_close_worker (struct link_map *map, bool force)
 	      j++;
 	    }
       ns_msl->r_nlist = j;
+      _dl_scope_index_update (ns_msl);
     }
 
-  if (!RTLD_SINGLE_THREAD_P
-      && (unload_global
-	  || scope_mem_left
-	  || (GL(dl_scope_free_list) != NULL
-	      && GL(dl_scope_free_list)->count)))
+  /* Other threads may still use a scope which refers to the objects
+     which are unmapped below, either the global scope or a scope which
+     was replaced above.  Wait for them.  A scope queued earlier by
+     _dl_scope_free can only refer to these objects if the current
+     scope of the same object does as well, and then it was replaced
+     above.  Otherwise the queued scopes are freed without waiting if
+     no thread uses them anymore, or by a later call.  */
+  if (!RTLD_SINGLE_THREAD_P && (unload_global || scope_retired))
     {
       THREAD_GSCOPE_WAIT ();
 
@@ -547,6 +546,8 @@ _dl_close_worker (struct link_map *map, bool force)
 	while (fsl->count > 0)
 	  free (fsl->list[--fsl->count]);
     }
+  else
+    _dl_scope_reclaim ();
 
   size_t tls_free_start;
   size_t tls_free_end;
@@ -563,7 +564,7 @@ _dl_close_worker (struct link_map *map, bool force)
   for (unsigned int i = first_loaded; i < nloaded; ++i)
     {
       struct link_map *imap = maps[i];
-      if (!used[i])
+      if (!imap->l_map_used)
 	{
 	  assert (imap->l_type == lt_loaded);
 
@@ -760,6 +761,8 @@ _dl_close_worker (struct link_map *map, bool force)
 
 	  /* Remove the searchlists.  */
 	  free (imap->l_initfini);
+	  if (__glibc_unlikely (imap->l_searchlist.r_index != NULL))
+	    _dl_scope_index_free (&imap->l_searchlist);
 
 	  /* Remove the scope array if we allocated it.  */
 	  if (imap->l_scope != imap->l_scope_mem)
@@ -789,8 +792,8 @@ _dl_close_worker (struct link_map *map, bool force)
       size_t newgen = GL(dl_tls_generation) + 1;
       if (__glibc_unlikely (newgen == 0))
 	_dl_fatal_printf ("TLS generation counter wrapped!  Please report as described in "REPORT_BUGS_TO".\n");
-      /* Can be read concurrently.  */
-      atomic_store_relaxed (&GL(dl_tls_generation), newgen);
+      /* Can be read concurrently.  Synchronize with __tls_get_addr.  */
+      atomic_store_release (&GL(dl_tls_generation), newgen);
 
       if (tls_free_end == GL(dl_tls_static_used))
 	GL(dl_tls_static_used) = tls_free_start;
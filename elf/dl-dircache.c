@@ -0,0 +1,35 @@
+/* Cache of directory contents for the shared object search.  Stub version.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dl-dircache.h>
+
+/* There is no portable way to list a directory in the dynamic linker,
+   so every lookup has to try to open the file.  */
+
+enum dl_dircache_result
+_dl_dircache_lookup (const struct r_search_path_elem *dir, size_t cnt,
+		     const char *dirname, size_t dirnamelen,
+		     const char *name, size_t namelen)
+{
+  return dl_dircache_unknown;
+}
+
+void
+_dl_dircache_release (void)
+{
+}
@@ -48,6 +48,13 @@ call_init (struct link_map *l, int argc, char **argv, char **env)
     _dl_debug_printf ("\ncalling init: %s\n\n",
 		      DSO_FILENAME (l->l_name));
 
+#ifdef SHARED
+  struct dl_profile_start profile;
+  bool profiling = __glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_PROFILE);
+  if (profiling)
+    _dl_profile_start (&profile);
+#endif
+
   /* Now run the local constructors.  There are two forms of them:
      - the one named by DT_INIT
      - the others in the DT_INIT_ARRAY.
@@ -69,6 +76,11 @@ call_init (struct link_map *l, int argc, char **argv, char **env)
       for (j = 0; j < jm; ++j)
 	((dl_init_t) addrs[j]) (argc, argv, env);
     }
+
+#ifdef SHARED
+  if (profiling)
+    _dl_profile_stop (&profile, l, dl_profile_init);
+#endif
 }
 
 
@@ -78,6 +90,12 @@ _dl_init (struct link_map *main_map, int argc, char **argv, char **env)
   ElfW(Dyn) *preinit_array = main_map->l_info[DT_PREINIT_ARRAY];
   ElfW(Dyn) *preinit_array_size = main_map->l_info[DT_PREINIT_ARRAYSZ];
   unsigned int i;
+#ifdef SHARED
+  /* The initial call for the main program, as opposed to calls from
+     dlopen.  */
+  bool startup = (main_map == GL(dl_ns)[LM_ID_BASE]._ns_loaded
+		  && !main_map->l_init_called);
+#endif
 
   if (__glibc_unlikely (GL(dl_initfirst) != NULL))
     {
@@ -120,4 +138,9 @@ _dl_init (struct link_map *main_map, int argc, char **argv, char **env)
   /* Finished starting up.  */
   _dl_starting_up = 0;
 #endif
+
+#ifdef SHARED
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_PROFILE) && startup)
+    _dl_profile_report ();
+#endif
 }
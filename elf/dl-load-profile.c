@@ -0,0 +1,250 @@
+/* Profile of the program startup for LD_DEBUG=profile.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <_itoa.h>
+#include <dl-pagefaults.h>
+#include <ldsodefs.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* With LD_DEBUG=profile, the dynamic linker records for every object
+   the time spent and the page faults incurred while mapping it
+   (_dl_map_object), relocating it (_dl_relocate_object) and running
+   its constructors (_dl_init), the number of symbol lookups done for
+   its relocations, and the number of files which could not be opened
+   while searching for it.  After the constructors of the initially
+   loaded objects have run, a JSON document with these counters is
+   written to the debug output:
+
+   {
+     "timing_type": "hp_timing",
+     "rtld_time": ...,
+     ...
+     "objects": [
+       {"name": "/lib64/libc.so.6", "namespace": 0, "map_time": ..., ...},
+       ...
+     ]
+   }
+
+   Times are in the units of the hp-timing clock (CPU cycles on most
+   architectures) and are only present if the architecture supports
+   hp-timing.  Objects loaded by dlopen later on are not reported.  */
+
+unsigned long int _dl_profile_failed_probes;
+
+#if HP_TIMING_INLINE
+/* Times recorded by rtld.  */
+static hp_timing_t rtld_total_time;
+static hp_timing_t rtld_load_time;
+static hp_timing_t rtld_relocate_time;
+#endif
+
+void
+_dl_profile_start (struct dl_profile_start *start)
+{
+#if HP_TIMING_INLINE
+  HP_TIMING_NOW (start->time);
+#else
+  start->time = 0;
+#endif
+  start->faults = _dl_pagefaults ();
+  start->failed_probes = _dl_profile_failed_probes;
+}
+
+void
+_dl_profile_stop (const struct dl_profile_start *start, struct link_map *map,
+		  enum dl_profile_phase phase)
+{
+#if HP_TIMING_INLINE
+  hp_timing_t now, diff;
+  HP_TIMING_NOW (now);
+  HP_TIMING_DIFF (diff, start->time, now);
+  map->l_profile.time[phase] += diff;
+#endif
+  map->l_profile.faults[phase] += _dl_pagefaults () - start->faults;
+  map->l_profile.failed_probes
+    += _dl_profile_failed_probes - start->failed_probes;
+}
+
+void
+_dl_profile_rtld_times (hp_timing_t total, hp_timing_t load,
+			hp_timing_t relocate)
+{
+#if HP_TIMING_INLINE
+  rtld_total_time = total;
+  rtld_load_time = load;
+  rtld_relocate_time = relocate;
+#endif
+}
+
+/* The report is collected in a buffer which is written to the debug
+   file descriptor whenever it is full.  */
+struct report_buffer
+{
+  size_t used;
+  char data[1024];
+};
+
+static void
+report_flush (struct report_buffer *buf)
+{
+  if (buf->used > 0)
+    _dl_write (GLRO(dl_debug_fd), buf->data, buf->used);
+  buf->used = 0;
+}
+
+static void
+report_add (struct report_buffer *buf, const char *s, size_t len)
+{
+  while (len > 0)
+    {
+      if (buf->used == sizeof (buf->data))
+	report_flush (buf);
+      size_t n = sizeof (buf->data) - buf->used;
+      if (n > len)
+	n = len;
+      memcpy (buf->data + buf->used, s, n);
+      buf->used += n;
+      s += n;
+      len -= n;
+    }
+}
+
+static void
+report_string (struct report_buffer *buf, const char *s)
+{
+  report_add (buf, s, strlen (s));
+}
+
+/* Add S as a quoted JSON string.  */
+static void
+report_json_string (struct report_buffer *buf, const char *s)
+{
+  report_add (buf, "\"", 1);
+  for (; *s != '\0'; ++s)
+    {
+      unsigned char c = *s;
+      if (c == '"' || c == '\\')
+	{
+	  char escaped[2] = { '\\', c };
+	  report_add (buf, escaped, sizeof (escaped));
+	}
+      else if (c < 0x20)
+	{
+	  char escaped[6] = { '\\', 'u', '0', '0',
+			      "0123456789abcdef"[c >> 4],
+			      "0123456789abcdef"[c & 15] };
+	  report_add (buf, escaped, sizeof (escaped));
+	}
+      else
+	report_add (buf, s, 1);
+    }
+  report_add (buf, "\"", 1);
+}
+
+/* Add ", "NAME": VALUE" to the report, without the comma if FIRST.  */
+static void
+report_member (struct report_buffer *buf, const char *name, uint64_t value,
+	       bool first)
+{
+  char digits[3 * sizeof (value) + 1];
+  char *end = digits + sizeof (digits);
+  char *cp = _itoa (value, end, 10, 0);
+
+  if (!first)
+    report_string (buf, ", ");
+  report_json_string (buf, name);
+  report_string (buf, ": ");
+  report_add (buf, cp, end - cp);
+}
+
+static void
+report_object (struct report_buffer *buf, struct link_map *l)
+{
+  const char *name = l->l_name;
+  if (name[0] == '\0' && l == GL(dl_ns)[LM_ID_BASE]._ns_loaded
+      && _dl_argv[0] != NULL)
+    name = _dl_argv[0];
+
+  report_string (buf, "    {\"name\": ");
+  report_json_string (buf, name);
+  report_member (buf, "namespace", l->l_ns, false);
+#if HP_TIMING_INLINE
+  report_member (buf, "map_time", l->l_profile.time[dl_profile_map], false);
+  report_member (buf, "relocate_time", l->l_profile.time[dl_profile_reloc],
+		 false);
+  report_member (buf, "init_time", l->l_profile.time[dl_profile_init],
+		 false);
+#endif
+  report_member (buf, "map_faults", l->l_profile.faults[dl_profile_map],
+		 false);
+  report_member (buf, "relocate_faults",
+		 l->l_profile.faults[dl_profile_reloc], false);
+  report_member (buf, "init_faults", l->l_profile.faults[dl_profile_init],
+		 false);
+  report_member (buf, "lookups", l->l_profile.lookups, false);
+  report_member (buf, "failed_probes", l->l_profile.failed_probes, false);
+  report_string (buf, "}");
+}
+
+void
+_dl_profile_report (void)
+{
+  static bool reported;
+  if (reported)
+    return;
+  reported = true;
+
+  struct report_buffer buf;
+  buf.used = 0;
+
+  report_string (&buf, "{\n  ");
+#if HP_TIMING_INLINE
+  report_string (&buf, "\"timing_type\": \"hp_timing\",\n  ");
+  report_member (&buf, "rtld_time", rtld_total_time, true);
+  report_string (&buf, ",\n  ");
+  report_member (&buf, "load_time", rtld_load_time, true);
+  report_string (&buf, ",\n  ");
+  report_member (&buf, "relocate_time", rtld_relocate_time, true);
+  report_string (&buf, ",\n  ");
+#endif
+  report_member (&buf, "page_faults", _dl_pagefaults (), true);
+  report_string (&buf, ",\n  ");
+  report_member (&buf, "relocations", GL(dl_num_relocations), true);
+  report_string (&buf, ",\n  ");
+  report_member (&buf, "relocations_from_cache",
+		 GL(dl_num_cache_relocations), true);
+  report_string (&buf, ",\n  \"objects\": [");
+
+  bool first = true;
+  for (Lmid_t ns = 0; ns < GL(dl_nns); ++ns)
+    for (struct link_map *l = GL(dl_ns)[ns]._ns_loaded; l != NULL;
+	 l = l->l_next)
+      {
+	/* Proxies and faked objects do not load anything.  */
+	if (l->l_proxy || l->l_faked)
+	  continue;
+	report_string (&buf, first ? "\n" : ",\n");
+	report_object (&buf, l);
+	first = false;
+      }
+
+  report_string (&buf, "\n  ]\n}\n");
+  report_flush (&buf);
+}
@@ -66,6 +66,7 @@ struct filebuf
 #include <libc-pointer-arith.h>
 #include <array_length.h>
 
+#include <dl-dircache.h>
 #include <dl-dst.h>
 #include <dl-load.h>
 #include <dl-map-segments.h>
@@ -1959,6 +1960,11 @@ open_verify (const char *name, int fd,
       free (abi_note_malloced);
     }
 
+#ifdef SHARED
+  if (fd == -1)
+    ++_dl_profile_failed_probes;
+#endif
+
   return fd;
 }
 
@@ -2026,8 +2032,13 @@ open_path (const char *name, size_t namelen, int mode,
 	  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_LIBS))
 	    _dl_debug_printf ("  trying file=%s\n", buf);
 
-	  fd = open_verify (buf, -1, fbp, loader, whatcode, mode,
-			    found_other_class, false);
+	  /* Do not try to open files which are not in the directory.  */
+	  if (_dl_dircache_lookup (this_dir, cnt, buf, buflen - namelen,
+				   name, namelen) == dl_dircache_absent)
+	    __set_errno (ENOENT);
+	  else
+	    fd = open_verify (buf, -1, fbp, loader, whatcode, mode,
+			      found_other_class, false);
 	  if (this_dir->status[cnt] == unknown)
 	    {
 	      if (fd != -1)
@@ -2244,6 +2255,13 @@ _dl_map_object (struct link_map *loader, const char *name,
       return l;
     }
 
+#ifdef SHARED
+  struct dl_profile_start profile;
+  bool profiling = __glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_PROFILE);
+  if (profiling)
+    _dl_profile_start (&profile);
+#endif
+
   /* Display information if we are debugging.  */
   if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES)
       && loader != NULL)
@@ -2509,8 +2527,13 @@ _dl_map_object (struct link_map *loader, const char *name,
     }
 
   void *stack_end = __libc_stack_end;
-  return _dl_map_object_from_fd (name, origname, fd, &fb, realname, loader,
-				 type, mode, &stack_end, nsid);
+  l = _dl_map_object_from_fd (name, origname, fd, &fb, realname, loader,
+			      type, mode, &stack_end, nsid);
+#ifdef SHARED
+  if (profiling)
+    _dl_profile_stop (&profile, l, dl_profile_map);
+#endif
+  return l;
 }
 
 struct add_path_state
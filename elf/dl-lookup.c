@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <ldsodefs.h>
 #include <dl-hash.h>
 #include <dl-machine.h>
@@ -31,6 +32,10 @@
 #include <tls.h>
 #include <atomic.h>
 #include <elf_machine_sym_no_match.h>
+#include <libc-pointer-arith.h>
+
+#define TUNABLE_NAMESPACE rtld
+#include <dl-tunables.h>
 
 #include <assert.h>
 
@@ -46,8 +51,10 @@ struct sym_val
 /* Statistics function.  */
 #ifdef SHARED
 # define bump_num_relocations() ++GL(dl_num_relocations)
+# define bump_num_cache_relocations() ++GL(dl_num_cache_relocations)
 #else
 # define bump_num_relocations() ((void) 0)
+# define bump_num_cache_relocations() ((void) 0)
 #endif
 
 /* Utility function for do_lookup_x. The caller is called with undef_name,
@@ -351,6 +358,350 @@ marking %s [%lu] as NODELETE due to unique symbol\n",
   result->m = (struct link_map *) map;
 }
 
+static uint_fast32_t
+dl_new_hash (const char *s)
+{
+  uint_fast32_t h = 5381;
+  for (unsigned char c = *s; c != '\0'; c = *++s)
+    h = h * 33 + c;
+  return h & 0xffffffff;
+}
+
+
+/* The global scope of a namespace can contain hundreds of objects, and
+   a lookup which does not find the symbol in the first objects probes
+   the hash tables of all of them.  To avoid this the global scope gets
+   an index of the symbols of all its objects, which maps each name to
+   the position of the first object in the scope with a symbol of that
+   name.  A name which is not in the index is not defined anywhere in
+   the scope.
+
+   The index is built by the first relocation which searches the scope,
+   so either dl_load_lock is held or the process is still single
+   threaded, and it is updated by dlopen and dlclose with the lock held.
+   Other lookups (lazy binding, dlsym) only read it, under the GSCOPE
+   flag in multi-threaded processes, so a replaced index is only freed
+   after THREAD_GSCOPE_WAIT.  */
+struct r_scope_index_entry
+{
+  const char *name;
+  /* GNU hash of the name, with the lowest bit cleared.  */
+  uint32_t hash;
+  /* Position of the first object in the scope with the symbol.  */
+  uint32_t pos;
+};
+
+struct r_scope_index
+{
+  /* The list and the number of objects in it the index describes.  */
+  struct link_map **list;
+  unsigned int nlist;
+  /* Size of the mapping.  */
+  size_t size;
+  /* Number of used entries, and the number of entries minus one.  */
+  size_t used;
+  size_t mask;
+  struct r_scope_index_entry entries[];
+};
+
+/* Return the minimum number of objects in a scope for which an index
+   is built, or zero if no index is to be built.  */
+static size_t
+scope_index_min (void)
+{
+#if HAVE_TUNABLES
+  static bool initialized;
+  static size_t min;
+  if (!initialized)
+    {
+      min = TUNABLE_GET (scope_index_min, size_t, NULL);
+      initialized = true;
+    }
+  return min;
+#else
+  return 0;
+#endif
+}
+
+/* Call FUNC for every symbol in the hash table of MAP which can be the
+   result of a lookup.  */
+static void
+scope_index_iterate (struct link_map *map,
+		     void (*func) (void *, const char *, uint32_t),
+		     void *closure)
+{
+  if (map->l_nbuckets == 0)
+    return;
+
+  const ElfW(Sym) *symtab = (const void *) D_PTR (map, l_info[DT_SYMTAB]);
+  const char *strtab = (const void *) D_PTR (map, l_info[DT_STRTAB]);
+
+  for (Elf_Symndx bucket = 0; bucket < map->l_nbuckets; ++bucket)
+    {
+      Elf_Symndx symidx;
+      uint32_t hash;
+      bool gnu = map->l_gnu_bitmask != NULL;
+      const Elf32_Word *hasharr = NULL;
+      if (gnu)
+	{
+	  if (map->l_gnu_buckets[bucket] == 0)
+	    continue;
+	  hasharr = &map->l_gnu_chain_zero[map->l_gnu_buckets[bucket]];
+	  symidx = ELF_MACHINE_HASH_SYMIDX (map, hasharr);
+	}
+      else
+	symidx = map->l_buckets[bucket];
+
+      while (symidx != STN_UNDEF)
+	{
+	  const ElfW(Sym) *sym = &symtab[symidx];
+	  unsigned int stt = ELFW(ST_TYPE) (sym->st_info);
+	  /* These are always rejected by check_match.  */
+	  bool skip = ((sym->st_value == 0
+			&& sym->st_shndx != SHN_ABS
+			&& stt != STT_TLS)
+		       || ((1 << stt) & ALLOWED_STT) == 0);
+
+	  if (gnu)
+	    {
+	      hash = *hasharr;
+	      if (!skip)
+		func (closure, strtab + sym->st_name, hash & ~1u);
+	      if (hash & 1u)
+		break;
+	      symidx = ELF_MACHINE_HASH_SYMIDX (map, ++hasharr);
+	    }
+	  else
+	    {
+	      if (!skip)
+		func (closure, strtab + sym->st_name,
+		      dl_new_hash (strtab + sym->st_name) & ~1u);
+	      symidx = map->l_chain[symidx];
+	    }
+	}
+    }
+}
+
+static void
+scope_index_count_one (void *closure, const char *name, uint32_t hash)
+{
+  ++*(size_t *) closure;
+}
+
+/* Return the number of symbols the objects at positions START to N of
+   LIST add to the index.  */
+static size_t
+scope_index_count (struct link_map **list, unsigned int start,
+		   unsigned int n)
+{
+  size_t count = 0;
+  for (unsigned int i = start; i < n; ++i)
+    scope_index_iterate (list[i]->l_real, scope_index_count_one, &count);
+  return count;
+}
+
+struct scope_index_insert_args
+{
+  struct r_scope_index *index;
+  uint32_t pos;
+};
+
+static void
+scope_index_insert (void *closure, const char *name, uint32_t hash)
+{
+  struct scope_index_insert_args *args = closure;
+  struct r_scope_index *index = args->index;
+
+  for (size_t i = (hash >> 1) & index->mask; ; i = (i + 1) & index->mask)
+    {
+      struct r_scope_index_entry *e = &index->entries[i];
+      if (e->name == NULL)
+	{
+	  e->hash = hash;
+	  e->pos = args->pos;
+	  /* Concurrent readers may see the entry as soon as the name is
+	     set.  */
+	  atomic_store_release (&e->name, name);
+	  ++index->used;
+	  return;
+	}
+      /* Only the first object with the name is recorded.  */
+      if (e->hash == hash && strcmp (e->name, name) == 0)
+	return;
+    }
+}
+
+/* Entries for names whose objects have been removed from the scope
+   point to this name.  No lookup matches it, and the probe sequences
+   of the other entries stay intact.  */
+static const char scope_index_removed_name[] = "";
+
+static void
+scope_index_remove_one (void *closure, const char *name, uint32_t hash)
+{
+  struct scope_index_insert_args *args = closure;
+  struct r_scope_index *index = args->index;
+
+  for (size_t i = (hash >> 1) & index->mask; ; i = (i + 1) & index->mask)
+    {
+      struct r_scope_index_entry *e = &index->entries[i];
+      if (e->name == NULL)
+	return;
+      if (e->hash == hash && strcmp (e->name, name) == 0)
+	{
+	  /* Keep the entry if an object which stays in the scope has
+	     the name as well.  */
+	  if (e->pos >= args->pos)
+	    atomic_store_release (&e->name, scope_index_removed_name);
+	  return;
+	}
+    }
+}
+
+/* Return true if the objects at positions N to END of LIST have all
+   been removed, that is, if removing them from the end of the list is
+   the only change.  */
+static bool
+scope_index_tail_removed (struct link_map **list, unsigned int n,
+			  unsigned int end)
+{
+  for (unsigned int i = n; i < end; ++i)
+    if (!list[i]->l_removed)
+      return false;
+  return true;
+}
+
+/* Add the objects at positions START to N of LIST to INDEX.  */
+static void
+scope_index_add (struct r_scope_index *index, struct link_map **list,
+		 unsigned int start, unsigned int n)
+{
+  struct scope_index_insert_args args = { .index = index };
+  for (args.pos = start; args.pos < n; ++args.pos)
+    scope_index_iterate (list[args.pos]->l_real, scope_index_insert, &args);
+}
+
+/* Build an index of the current objects of SCOPE.  Return NULL if no
+   memory is available.  */
+static struct r_scope_index *
+scope_index_create (struct r_scope_elem *scope)
+{
+  struct link_map **list = scope->r_list;
+  unsigned int n = scope->r_nlist;
+
+  /* Keep the load factor below one half.  */
+  size_t count = scope_index_count (list, 0, n);
+  size_t entries = 64;
+  while (entries < 2 * count)
+    entries *= 2;
+
+  size_t size = ALIGN_UP (sizeof (struct r_scope_index)
+			  + entries * sizeof (struct r_scope_index_entry),
+			  GLRO(dl_pagesize));
+  struct r_scope_index *index = __mmap (NULL, size, PROT_READ | PROT_WRITE,
+					MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+  if (index == MAP_FAILED)
+    return NULL;
+
+  index->list = list;
+  index->size = size;
+  index->used = 0;
+  index->mask = entries - 1;
+  scope_index_add (index, list, 0, n);
+  index->nlist = n;
+
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_SCOPES))
+    _dl_debug_printf ("\nsymbol index of global scope: %u objects,"
+		      " %lu symbols\n", n, (unsigned long int) index->used);
+
+  return index;
+}
+
+/* Free INDEX once no concurrent lookup can use it anymore.  */
+static void
+scope_index_release (struct r_scope_index *index)
+{
+  if (index == NULL)
+    return;
+  if (!RTLD_SINGLE_THREAD_P)
+    THREAD_GSCOPE_WAIT ();
+  __munmap (index, index->size);
+}
+
+/* Return the position of the first object in INDEX with a symbol named
+   UNDEF_NAME, or UINT32_MAX if there is none.  */
+static uint32_t
+scope_index_find (const struct r_scope_index *index, const char *undef_name,
+		  uint_fast32_t new_hash)
+{
+  uint32_t hash = new_hash & ~1u;
+  for (size_t i = (hash >> 1) & index->mask; ; i = (i + 1) & index->mask)
+    {
+      const struct r_scope_index_entry *e = &index->entries[i];
+      const char *name = atomic_load_acquire (&e->name);
+      if (name == NULL)
+	return UINT32_MAX;
+      if (e->hash == hash && strcmp (name, undef_name) == 0)
+	return e->pos;
+    }
+}
+
+void
+_dl_scope_index_update (struct r_scope_elem *scope)
+{
+  struct r_scope_index *index = scope->r_index;
+  if (index == NULL)
+    return;
+
+  /* Objects which were appended to the same list can be added in
+     place, as long as the load factor stays below one half.  */
+  if (index->list == scope->r_list && index->nlist <= scope->r_nlist)
+    {
+      size_t count = scope_index_count (scope->r_list, index->nlist,
+					scope->r_nlist);
+      if (2 * (index->used + count) <= index->mask + 1)
+	{
+	  scope_index_add (index, scope->r_list, index->nlist,
+			   scope->r_nlist);
+	  atomic_store_release (&index->nlist, scope->r_nlist);
+	  return;
+	}
+    }
+
+  /* Objects which were removed from the end of the same list are
+     removed from the index in place.  They are still mapped, and their
+     names are still in the list after the new end.  The removed
+     entries keep counting towards the load factor.  */
+  if (index->list == scope->r_list && scope->r_nlist < index->nlist
+      && scope_index_tail_removed (scope->r_list, scope->r_nlist,
+				   index->nlist))
+    {
+      struct scope_index_insert_args args =
+	{ .index = index, .pos = scope->r_nlist };
+      for (unsigned int i = scope->r_nlist; i < index->nlist; ++i)
+	scope_index_iterate (scope->r_list[i]->l_real,
+			     scope_index_remove_one, &args);
+      atomic_store_release (&index->nlist, scope->r_nlist);
+      return;
+    }
+
+  /* Otherwise build a new index.  */
+  size_t min = scope_index_min ();
+  struct r_scope_index *new = NULL;
+  if (min != 0 && scope->r_nlist >= min)
+    new = scope_index_create (scope);
+  atomic_store_release (&scope->r_index, new);
+  scope_index_release (index);
+}
+
+void
+_dl_scope_index_free (struct r_scope_elem *scope)
+{
+  struct r_scope_index *index = scope->r_index;
+  atomic_store_release (&scope->r_index, NULL);
+  scope_index_release (index);
+}
+
 /* Inner part of the lookup functions.  We return a value > 0 if we
    found the symbol, the value 0 if nothing is found and < 0 if
    something bad happened.  */
@@ -370,6 +721,33 @@ do_lookup_x (const char *undef_name, uint_fast32_t new_hash,
   __asm volatile ("" : "+r" (n), "+m" (scope->r_list));
   struct link_map **list = scope->r_list;
 
+  /* Skip the objects without a symbol of this name if the scope has an
+     index.  The index is built by the first relocation which searches
+     the global scope.  */
+  struct r_scope_index *index = atomic_load_acquire (&scope->r_index);
+  if (index == NULL
+      && __glibc_unlikely (flags & DL_LOOKUP_FOR_RELOCATE)
+      && undef_map != NULL
+      && scope == GL(dl_ns)[undef_map->l_ns]._ns_main_searchlist)
+    {
+      size_t min = scope_index_min ();
+      if (min != 0 && n >= min)
+	{
+	  index = scope_index_create (scope);
+	  atomic_store_release (&scope->r_index, index);
+	}
+    }
+  if (index != NULL
+      && index->list == list
+      && atomic_load_acquire (&index->nlist) == n)
+    {
+      uint32_t pos = scope_index_find (index, undef_name, new_hash);
+      if (pos >= n)
+	return 0;
+      if (pos > i)
+	i = pos;
+    }
+
   do
     {
       const struct link_map *map = list[i]->l_real;
@@ -575,15 +953,6 @@ skip:
 }
 
 
-static uint_fast32_t
-dl_new_hash (const char *s)
-{
-  uint_fast32_t h = 5381;
-  for (unsigned char c = *s; c != '\0'; c = *++s)
-    h = h * 33 + c;
-  return h & 0xffffffff;
-}
-
 
 /* Add extra dependency on MAP to UNDEF_MAP.  */
 static int
@@ -826,6 +1195,144 @@ _dl_debug_bindings (const char *undef_name, struct link_map *undef_map,
 		    int protected);
 
 
+#ifdef SHARED
+/* During the initial relocation, most lookups search the global scope
+   for the same names again and again: every object refers to malloc,
+   memcpy, the C++ runtime and so on.  The results of such lookups are
+   remembered by name, version (including whether it is hidden, which
+   check_match takes into account) and type class so that the scope is
+   only searched once per symbol.  Lookups whose result may depend on the
+   referencing object (protected symbols, copy relocations, local
+   scopes as for DT_SYMBOLIC, unique symbols) are not memoized.  */
+struct lookup_memo_entry
+{
+  const char *name;
+  const char *version;
+  ElfW(Word) version_hash;
+  bool version_hidden;
+  uint32_t hash;
+  int type_class;
+  struct link_map *map;
+  const ElfW(Sym) *sym;
+};
+
+static struct
+{
+  struct lookup_memo_entry *entries;
+  size_t mask;
+  size_t used;
+} lookup_memo;
+
+void
+_dl_lookup_memo_start (void)
+{
+  size_t size = 4096;
+  void *p = __mmap (NULL, size * sizeof (struct lookup_memo_entry),
+		    PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
+		    -1, 0);
+  if (p == MAP_FAILED)
+    return;
+  lookup_memo.entries = p;
+  lookup_memo.mask = size - 1;
+  lookup_memo.used = 0;
+}
+
+void
+_dl_lookup_memo_end (void)
+{
+  if (lookup_memo.entries != NULL)
+    __munmap (lookup_memo.entries,
+	      (lookup_memo.mask + 1) * sizeof (struct lookup_memo_entry));
+  lookup_memo.entries = NULL;
+}
+
+/* Return true if the result of the lookup only depends on the name,
+   version and type class.  */
+static bool
+lookup_memo_applies (struct link_map *undef_map, const ElfW(Sym) *ref,
+		     struct r_scope_elem *symbol_scope[], int type_class,
+		     int flags, struct link_map *skip_map)
+{
+  return (undef_map != NULL
+	  && (flags & DL_LOOKUP_RETURN_NEWEST) == 0
+	  && undef_map->l_ns == LM_ID_BASE
+	  && skip_map == NULL
+	  && ref != NULL
+	  && ELFW(ST_VISIBILITY) (ref->st_other) != STV_PROTECTED
+	  && (type_class & ELF_RTYPE_CLASS_COPY) == 0
+	  && symbol_scope[0] == &GL(dl_ns)[LM_ID_BASE]._ns_loaded->l_searchlist
+	  && symbol_scope[1] == NULL
+	  && !(GLRO(dl_debug_mask) & (DL_DEBUG_BINDINGS|DL_DEBUG_PRELINK)));
+}
+
+/* Return the entry for the lookup, or the free entry where it is to be
+   stored.  */
+static struct lookup_memo_entry *
+lookup_memo_find (const char *undef_name, uint32_t hash,
+		  const struct r_found_version *version, int type_class)
+{
+  for (size_t i = hash & lookup_memo.mask; ; i = (i + 1) & lookup_memo.mask)
+    {
+      struct lookup_memo_entry *e = &lookup_memo.entries[i];
+      if (e->name == NULL)
+	return e;
+      if (e->hash == hash
+	  && e->type_class == type_class
+	  && (version == NULL
+	      ? e->version == NULL
+	      : (e->version != NULL
+		 && e->version_hash == version->hash
+		 && e->version_hidden == (version->hidden != 0)
+		 && strcmp (e->version, version->name) == 0))
+	  && strcmp (e->name, undef_name) == 0)
+	return e;
+    }
+}
+
+static void
+lookup_memo_insert (const char *undef_name, uint32_t hash,
+		    const struct r_found_version *version, int type_class,
+		    struct link_map *map, const ElfW(Sym) *sym)
+{
+  /* Keep the load factor below one half.  */
+  if (2 * (lookup_memo.used + 1) > lookup_memo.mask + 1)
+    {
+      struct lookup_memo_entry *old = lookup_memo.entries;
+      size_t oldsize = lookup_memo.mask + 1;
+      void *p = __mmap (NULL, 2 * oldsize * sizeof (struct lookup_memo_entry),
+			PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
+			-1, 0);
+      if (p == MAP_FAILED)
+	return;
+      lookup_memo.entries = p;
+      lookup_memo.mask = 2 * oldsize - 1;
+      for (size_t i = 0; i < oldsize; ++i)
+	if (old[i].name != NULL)
+	  {
+	    size_t j = old[i].hash & lookup_memo.mask;
+	    while (lookup_memo.entries[j].name != NULL)
+	      j = (j + 1) & lookup_memo.mask;
+	    lookup_memo.entries[j] = old[i];
+	  }
+      __munmap (old, oldsize * sizeof (struct lookup_memo_entry));
+    }
+
+  struct lookup_memo_entry *e = lookup_memo_find (undef_name, hash, version,
+						  type_class);
+  if (e->name != NULL)
+    return;
+  e->name = undef_name;
+  e->version = version != NULL ? version->name : NULL;
+  e->version_hash = version != NULL ? version->hash : 0;
+  e->version_hidden = version != NULL && version->hidden != 0;
+  e->hash = hash;
+  e->type_class = type_class;
+  e->map = map;
+  e->sym = sym;
+  ++lookup_memo.used;
+}
+#endif /* SHARED */
+
 /* Search loaded objects' symbol tables for a definition of the symbol
    UNDEF_NAME, perhaps with a requested version for the symbol.
 
@@ -845,11 +1352,35 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
   struct r_scope_elem **scope = symbol_scope;
 
   bump_num_relocations ();
+#ifdef SHARED
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_PROFILE)
+      && undef_map != NULL)
+    ++undef_map->l_profile.lookups;
+#endif
 
   /* DL_LOOKUP_RETURN_NEWEST does not make sense for versioned
      lookups.  */
   assert (version == NULL || !(flags & DL_LOOKUP_RETURN_NEWEST));
 
+#ifdef SHARED
+  bool memo = (__glibc_unlikely (lookup_memo.entries != NULL)
+	       && lookup_memo_applies (undef_map, *ref, symbol_scope,
+				       type_class, flags, skip_map));
+  if (memo)
+    {
+      struct lookup_memo_entry *e = lookup_memo_find (undef_name, new_hash,
+						      version, type_class);
+      if (e->name != NULL)
+	{
+	  bump_num_cache_relocations ();
+	  if (__glibc_unlikely (e->map->l_used == 0))
+	    e->map->l_used = 1;
+	  *ref = e->sym;
+	  return LOOKUP_VALUE (e->map);
+	}
+    }
+#endif
+
   size_t i = 0;
   if (__glibc_unlikely (skip_map != NULL))
     /* Search the relevant loaded objects for a definition.  */
@@ -866,7 +1397,8 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
   if (__glibc_unlikely (current_value.s == NULL))
     {
       if ((*ref == NULL || ELFW(ST_BIND) ((*ref)->st_info) != STB_WEAK)
-	  && !(GLRO(dl_debug_mask) & DL_DEBUG_UNUSED))
+	  && !(GLRO(dl_debug_mask) & DL_DEBUG_UNUSED)
+	  && !(flags & DL_LOOKUP_SPECULATIVE))
 	{
 	  /* We could find no value for a strong reference.  */
 	  const char *reference_name = undef_map ? undef_map->l_name : "";
@@ -966,6 +1498,15 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
     _dl_debug_bindings (undef_name, undef_map, ref,
 			&current_value, version, type_class, protected);
 
+#ifdef SHARED
+  if (memo
+      && current_value.m == current_value.m->l_real
+      && ELFW(ST_BIND) (current_value.s->st_info) != STB_GNU_UNIQUE
+      && ELFW(ST_VISIBILITY) (current_value.s->st_other) != STV_PROTECTED)
+    lookup_memo_insert (undef_name, new_hash, version, type_class,
+			current_value.m, current_value.s);
+#endif
+
   *ref = current_value.s;
   return LOOKUP_VALUE (current_value.m->l_real);
 }
@@ -92,6 +92,9 @@ struct dl_main_state
      Colon-separated list.  */
   const char *glibc_hwcaps_mask;
 
+  /* The relocation cache file from LD_RELOC_CACHE.  */
+  const char *reloc_cache;
+
   enum rtld_mode mode;
 
   /* True if any of the debugging options is enabled.  */
@@ -37,6 +37,7 @@
 #include <libc-early-init.h>
 #include <gnu/lib-names.h>
 
+#include <dl-dircache.h>
 #include <dl-dst.h>
 #include <dl-prop.h>
 
@@ -175,10 +176,9 @@ add_to_global_resize (struct link_map *new)
       ns->_ns_global_scope_alloc = new_size;
       ns->_ns_main_searchlist->r_list = new_global;
 
-      if (!RTLD_SINGLE_THREAD_P)
-	THREAD_GSCOPE_WAIT ();
-
-      free (old_global);
+      /* Concurrent lookups may still use the old array.  */
+      if (old_global != NULL)
+	_dl_scope_free (old_global);
     }
 }
 
@@ -219,6 +219,8 @@ add_to_global_update (struct link_map *new)
 
   atomic_write_barrier ();
   ns->_ns_main_searchlist->r_nlist = new_nlist;
+
+  _dl_scope_index_update (ns->_ns_main_searchlist);
 }
 
 /* Search link maps in all namespaces for the DSO that contains the object at
@@ -419,8 +421,10 @@ update_tls_slotinfo (struct link_map *new)
   if (__glibc_unlikely (newgen == 0))
     _dl_fatal_printf (N_("\
 TLS generation counter wrapped!  Please report this."));
-  /* Can be read concurrently.  */
-  atomic_store_relaxed (&GL(dl_tls_generation), newgen);
+  /* Can be read concurrently.  Synchronize with the acquire load in
+     __tls_get_addr, so that slotinfo entries of the new generation are
+     visible to threads which update their dtv to it.  */
+  atomic_store_release (&GL(dl_tls_generation), newgen);
 
   /* We need a second pass for static tls data, because
      _dl_update_slotinfo must not be run while calls to
@@ -437,8 +441,8 @@ TLS generation counter wrapped!  Please report this."));
 	     now, but we can delay updating the DTV.  */
 	  imap->l_need_tls_init = 0;
 #ifdef SHARED
-	  /* Update the slot information data for at least the
-	     generation of the DSO we are allocating data for.  */
+	  /* Update the slot information data for the new generation,
+	     which includes the DSO we are allocating data for.  */
 
 	  /* FIXME: This can terminate the process on memory
 	     allocation failure.  It is not possible to raise
@@ -446,7 +450,7 @@ TLS generation counter wrapped!  Please report this."));
 	     _dl_update_slotinfo would have to be split into two
 	     operations, similar to resize_scopes and update_scopes
 	     above.  This is related to bug 16134.  */
-	  _dl_update_slotinfo (imap->l_tls_modid);
+	  _dl_update_slotinfo (imap->l_tls_modid, newgen);
 #endif
 
 	  dl_init_static_tls (imap);
@@ -905,6 +909,10 @@ dl_open_worker (void *a)
 
     __rtld_lock_unlock_recursive (GL(dl_load_tls_lock));
 
+    /* The constructors may change the directories which were
+       searched.  */
+    _dl_dircache_release ();
+
     if (__glibc_unlikely (ex.errstring != NULL))
       /* Reraise the error.  */
       _dl_signal_exception (err, &ex, NULL);
@@ -1071,6 +1079,9 @@ no more namespaces available for dlmopen()"));
 
   assert (_dl_debug_update (args.nsid)->r_state == RT_CONSISTENT);
 
+  /* Free the scopes replaced while loading if possible.  */
+  _dl_scope_reclaim ();
+
   /* Release the lock.  */
   __rtld_lock_unlock_recursive (GL(dl_load_lock));
 
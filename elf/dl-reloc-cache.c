@@ -0,0 +1,542 @@
+/* Persistent cache of the symbol bindings of the initial relocation.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <alloca.h>
+#include <fcntl.h>
+#include <ldsodefs.h>
+#include <libc-pointer-arith.h>
+#include <not-cancel.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sysdep.h>
+
+/* With LD_RELOC_CACHE=FILE, the dynamic linker records the result of
+   every symbol lookup done while relocating the initially loaded
+   objects, and writes them to FILE.  As long as the same objects are
+   loaded, the relocation processing does the same lookups in the same
+   order.  Later runs then take the results from FILE instead of
+   searching the scopes.
+
+   The cache is only used if FILE describes exactly the objects that
+   are loaded now: the same names in the same order, with the same
+   device, inode, size and modification time, and the same build ID.
+   Lookups are identified by the referencing object, its symbol index
+   and the relocation type class.  If a lookup does not match the next
+   recorded one, the remaining lookups are done normally and the cache
+   is rewritten.
+
+   The file is written to FILE.tmp first and then renamed, so readers
+   never see partial files.  Concurrent writers may still produce a
+   corrupt file; this is detected by the checksum and the file is
+   rewritten.  */
+
+#define RELOC_CACHE_MAGIC "ld.so-reloc-1"
+
+struct reloc_cache_header
+{
+  char magic[16];
+  uint32_t flags;
+  uint32_t nobjects;
+  uint32_t nentries;
+  uint32_t strsize;
+  /* Checksum of everything following the header.  */
+  uint64_t checksum;
+};
+
+/* Settings which influence the lookups.  */
+enum
+  {
+    RELOC_CACHE_LAZY = 1,
+    RELOC_CACHE_DYNAMIC_WEAK = 2,
+  };
+
+struct reloc_cache_object
+{
+  uint64_t dev;
+  uint64_t ino;
+  uint64_t size;
+  int64_t mtime_sec;
+  int64_t mtime_nsec;
+  /* Hash of the NT_GNU_BUILD_ID note, or zero.  */
+  uint64_t build_id;
+  /* Offset of l_name in the string table.  */
+  uint32_t name;
+  uint32_t pad;
+};
+
+struct reloc_cache_entry
+{
+  uint16_t undef_object;
+  uint16_t type_class;
+  uint32_t undef_sym;
+  uint32_t def_object;
+  uint32_t def_sym;
+};
+
+/* Values of def_object which do not refer to an object.  The symbol
+   was a weak undefined reference which was not found, or the lookup
+   has to be done because it has side effects (STB_GNU_UNIQUE).  */
+#define RELOC_CACHE_UNDEF ((uint32_t) -1)
+#define RELOC_CACHE_LOOKUP ((uint32_t) -2)
+
+int _dl_reloc_cache_active;
+
+static struct
+{
+  const char *file;
+
+  /* The objects in the base namespace.  Their l_idx is set to their
+     index in this array while the cache is active.  */
+  struct link_map **maps;
+  uint32_t nmaps;
+
+  /* Description of these objects, as stored in the file.  */
+  struct reloc_cache_object *objects;
+  /* The number of symbols of each object, if FILE is replayed.  */
+  uint32_t *nsyms;
+  char *strings;
+  uint32_t strsize;
+  uint32_t flags;
+
+  /* The contents of FILE, and the entries in it.  Entries before NEXT
+     have been replayed.  */
+  void *file_data;
+  size_t file_size;
+  const struct reloc_cache_entry *replay;
+  uint32_t nreplay;
+  uint32_t next;
+
+  /* The lookups of this run, once it deviates from FILE.  */
+  bool recording;
+  bool failed;
+  struct reloc_cache_entry *record;
+  uint32_t nrecord;
+  uint32_t record_size;
+} cache;
+
+static uint64_t
+reloc_cache_hash (uint64_t hash, const void *data, size_t size)
+{
+  const unsigned char *p = data;
+  for (size_t i = 0; i < size; ++i)
+    hash = (hash ^ p[i]) * 0x100000001b3ULL;
+  return hash;
+}
+
+/* The checksum is computed on 64-bit words, which is sufficient to
+   detect corruption and much faster than hashing bytes.  SIZE is a
+   multiple of 8.  */
+static uint64_t
+reloc_cache_checksum (uint64_t sum, const void *data, size_t size)
+{
+  const uint64_t *p = data;
+  for (size_t i = 0; i < size / sizeof (uint64_t); ++i)
+    sum = ((sum ^ p[i]) * 0x100000001b3ULL) ^ (sum >> 29);
+  return sum;
+}
+
+/* Return a hash of the build ID of L, or zero if it has none.  */
+static uint64_t
+object_build_id (const struct link_map *l)
+{
+  for (const ElfW(Phdr) *ph = l->l_phdr; ph < &l->l_phdr[l->l_phnum]; ++ph)
+    if (ph->p_type == PT_NOTE)
+      {
+	size_t align = ph->p_align == 8 ? 8 : 4;
+	const char *p = (const char *) (l->l_addr + ph->p_vaddr);
+	const char *end = p + ph->p_memsz;
+	while (p < end && end - p >= (ptrdiff_t) sizeof (ElfW(Nhdr)))
+	  {
+	    const ElfW(Nhdr) *note = (const ElfW(Nhdr) *) p;
+	    const char *name = p + sizeof (ElfW(Nhdr));
+	    const char *desc = name + ALIGN_UP (note->n_namesz, align);
+	    if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4
+		&& memcmp (name, "GNU", 4) == 0)
+	      return reloc_cache_hash (0xcbf29ce484222325ULL, desc,
+				       note->n_descsz);
+	    p = desc + ALIGN_UP (note->n_descsz, align);
+	  }
+      }
+  return 0;
+}
+
+static void
+describe_object (struct link_map *l, struct reloc_cache_object *obj)
+{
+  const char *path = l->l_name;
+  if (l->l_type == lt_executable && path[0] == '\0')
+    path = "/proc/self/exe";
+#ifdef NEED_DL_SYSINFO_DSO
+  /* The vDSO has no file.  */
+  if (l == GLRO(dl_sysinfo_map))
+    path = "";
+#endif
+
+  struct __stat64_t64 st;
+  if (path[0] != '\0' && __stat64_time64 (path, &st) == 0)
+    {
+      obj->dev = st.st_dev;
+      obj->ino = st.st_ino;
+      obj->size = st.st_size;
+      obj->mtime_sec = st.st_mtim.tv_sec;
+      obj->mtime_nsec = st.st_mtim.tv_nsec;
+    }
+  obj->build_id = object_build_id (l);
+}
+
+/* Return the number of entries in the symbol table of L.  Only
+   symbols in the hash table can be the result of a lookup, so this is
+   one more than the largest index in it.  */
+static uint32_t
+object_nsyms (const struct link_map *l)
+{
+  if (l->l_nbuckets == 0)
+    return 0;
+
+  if (l->l_gnu_bitmask == NULL)
+    {
+      const Elf_Symndx *hash = (const void *) D_PTR (l, l_info[DT_HASH]);
+      return hash[1];
+    }
+
+  /* The chains are stored in the order of the buckets, so the last
+     chain starts at the largest bucket value.  */
+  Elf32_Word symidx = 0;
+  for (Elf32_Word bucket = 0; bucket < l->l_nbuckets; ++bucket)
+    if (l->l_gnu_buckets[bucket] > symidx)
+      symidx = l->l_gnu_buckets[bucket];
+  if (symidx == 0)
+    return 0;
+  while ((l->l_gnu_chain_zero[symidx] & 1u) == 0)
+    ++symidx;
+  return symidx + 1;
+}
+
+/* Use the entries in DATA if it is a valid cache for the loaded
+   objects.  */
+static bool
+reloc_cache_load (const void *data, size_t size)
+{
+  const struct reloc_cache_header *header = data;
+  if (size < sizeof (*header)
+      || memcmp (header->magic, RELOC_CACHE_MAGIC,
+		 sizeof (RELOC_CACHE_MAGIC)) != 0
+      || header->flags != cache.flags
+      || header->nobjects != cache.nmaps
+      || header->strsize != cache.strsize)
+    return false;
+
+  size_t objsize = cache.nmaps * sizeof (struct reloc_cache_object);
+  size_t strsize = ALIGN_UP (cache.strsize, 8);
+  size_t expected = (sizeof (*header) + objsize + strsize
+		     + (size_t) header->nentries
+		       * sizeof (struct reloc_cache_entry));
+  if (size != expected)
+    return false;
+
+  const char *p = (const char *) (header + 1);
+  if (reloc_cache_checksum (0, p, size - sizeof (*header))
+      != header->checksum
+      || memcmp (p, cache.objects, objsize) != 0
+      || memcmp (p + objsize, cache.strings, strsize) != 0)
+    return false;
+
+  /* The checksum does not protect against a file written on purpose,
+     so the symbols the entries refer to are checked when they are
+     replayed.  */
+  cache.nsyms = malloc (cache.nmaps * sizeof (uint32_t));
+  if (cache.nsyms == NULL)
+    return false;
+  for (uint32_t i = 0; i < cache.nmaps; ++i)
+    cache.nsyms[i] = object_nsyms (cache.maps[i]);
+
+  cache.replay = (const struct reloc_cache_entry *) (p + objsize + strsize);
+  cache.nreplay = header->nentries;
+  return true;
+}
+
+void
+_dl_reloc_cache_setup (const char *file)
+{
+  uint32_t nmaps = 0;
+  size_t strsize = 0;
+  for (struct link_map *l = GL(dl_ns)[LM_ID_BASE]._ns_loaded; l != NULL;
+       l = l->l_next)
+    {
+      ++nmaps;
+      strsize += strlen (l->l_name) + 1;
+    }
+  if (nmaps > UINT16_MAX || strsize > UINT32_MAX)
+    return;
+
+  cache.file = file;
+  cache.nmaps = nmaps;
+  cache.strsize = strsize;
+  cache.maps = malloc (nmaps * sizeof (struct link_map *));
+  cache.objects = calloc (nmaps, sizeof (struct reloc_cache_object));
+  cache.strings = calloc (ALIGN_UP (strsize, 8), 1);
+  if (cache.maps == NULL || cache.objects == NULL || cache.strings == NULL)
+    return;
+
+  uint32_t i = 0;
+  char *name = cache.strings;
+  for (struct link_map *l = GL(dl_ns)[LM_ID_BASE]._ns_loaded; l != NULL;
+       l = l->l_next, ++i)
+    {
+      cache.maps[i] = l;
+      l->l_idx = i;
+      describe_object (l, &cache.objects[i]);
+      cache.objects[i].name = name - cache.strings;
+      name = __stpcpy (name, l->l_name) + 1;
+    }
+
+  cache.flags = ((GLRO(dl_lazy) ? RELOC_CACHE_LAZY : 0)
+		 | (GLRO(dl_dynamic_weak) ? RELOC_CACHE_DYNAMIC_WEAK : 0));
+
+  cache.file_data = _dl_sysdep_read_whole_file (file, &cache.file_size,
+						PROT_READ);
+  if (cache.file_data == MAP_FAILED
+      || !reloc_cache_load (cache.file_data, cache.file_size))
+    cache.recording = true;
+
+  _dl_reloc_cache_active = 1;
+}
+
+static void
+reloc_cache_append (const struct reloc_cache_entry *entries, uint32_t n)
+{
+  if (cache.failed)
+    return;
+
+  if (cache.record_size - cache.nrecord < n)
+    {
+      uint32_t size = cache.record_size == 0 ? 4096 : cache.record_size;
+      while (size - cache.nrecord < n)
+	size *= 2;
+      void *p = __mmap (NULL, size * sizeof (struct reloc_cache_entry),
+			PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE,
+			-1, 0);
+      if (p == MAP_FAILED)
+	{
+	  cache.failed = true;
+	  return;
+	}
+      if (cache.record != NULL)
+	{
+	  memcpy (p, cache.record,
+		  cache.nrecord * sizeof (struct reloc_cache_entry));
+	  __munmap (cache.record,
+		    cache.record_size * sizeof (struct reloc_cache_entry));
+	}
+      cache.record = p;
+      cache.record_size = size;
+    }
+
+  memcpy (&cache.record[cache.nrecord], entries,
+	  n * sizeof (struct reloc_cache_entry));
+  cache.nrecord += n;
+}
+
+/* Return true if the result of R refers to a symbol of a loaded
+   object.  */
+static bool
+reloc_cache_def_valid (const struct reloc_cache_entry *r)
+{
+  return (r->def_object == RELOC_CACHE_UNDEF
+	  || r->def_object == RELOC_CACHE_LOOKUP
+	  || (r->def_object < cache.nmaps
+	      && r->def_sym < cache.nsyms[r->def_object]));
+}
+
+/* Stop replaying.  The lookups so far are those in the file, so they
+   become the start of the new cache.  */
+static void
+reloc_cache_diverge (void)
+{
+  cache.recording = true;
+  reloc_cache_append (cache.replay, cache.next);
+  cache.nreplay = 0;
+}
+
+lookup_t
+_dl_reloc_cache_lookup (const char *undef_name, struct link_map *undef_map,
+			const ElfW(Sym) **ref,
+			struct r_scope_elem *symbol_scope[],
+			const struct r_found_version *version,
+			int type_class, int flags)
+{
+  uint32_t undef_idx = undef_map->l_idx;
+  if (undef_idx >= cache.nmaps || cache.maps[undef_idx] != undef_map)
+    /* Not an initially loaded object, e.g. loaded by dlopen from an
+       IFUNC resolver.  This happens in every run, so no need to keep
+       track of it.  */
+    return _dl_lookup_symbol_x (undef_name, undef_map, ref, symbol_scope,
+				version, type_class, flags, NULL);
+
+  const ElfW(Sym) *symtab
+    = (const ElfW(Sym) *) D_PTR (undef_map, l_info[DT_SYMTAB]);
+  struct reloc_cache_entry entry =
+    {
+      .undef_object = undef_idx,
+      .type_class = type_class,
+      .undef_sym = *ref - symtab,
+    };
+
+  if (!cache.recording && cache.next < cache.nreplay)
+    {
+      const struct reloc_cache_entry *r = &cache.replay[cache.next];
+      if (r->undef_object == entry.undef_object
+	  && r->type_class == entry.type_class
+	  && r->undef_sym == entry.undef_sym
+	  && reloc_cache_def_valid (r))
+	{
+	  ++cache.next;
+	  if (r->def_object == RELOC_CACHE_UNDEF)
+	    {
+	      *ref = NULL;
+	      return NULL;
+	    }
+	  if (r->def_object != RELOC_CACHE_LOOKUP)
+	    {
+	      struct link_map *map = cache.maps[r->def_object];
+	      *ref = ((const ElfW(Sym) *) D_PTR (map, l_info[DT_SYMTAB])
+		      + r->def_sym);
+	      /* See _dl_lookup_symbol_x.  */
+	      if (__glibc_unlikely (map->l_real->l_used == 0))
+		map->l_real->l_used = 1;
+	      return map;
+	    }
+	  return _dl_lookup_symbol_x (undef_name, undef_map, ref, symbol_scope,
+				      version, type_class, flags, NULL);
+	}
+    }
+  if (!cache.recording)
+    reloc_cache_diverge ();
+
+  lookup_t result = _dl_lookup_symbol_x (undef_name, undef_map, ref,
+					 symbol_scope, version, type_class,
+					 flags, NULL);
+
+  if (result == NULL)
+    entry.def_object = RELOC_CACHE_UNDEF;
+  else if ((uint32_t) result->l_idx < cache.nmaps
+	   && cache.maps[result->l_idx] == result
+	   && ELFW(ST_BIND) ((*ref)->st_info) != STB_GNU_UNIQUE)
+    {
+      entry.def_object = result->l_idx;
+      entry.def_sym = *ref - (const ElfW(Sym) *) D_PTR (result,
+							 l_info[DT_SYMTAB]);
+    }
+  else
+    entry.def_object = RELOC_CACHE_LOOKUP;
+  reloc_cache_append (&entry, 1);
+
+  return result;
+}
+
+static bool
+reloc_cache_write_all (int fd, const void *data, size_t size)
+{
+  const char *p = data;
+  while (size > 0)
+    {
+      ssize_t n = TEMP_FAILURE_RETRY (__write_nocancel (fd, p, size));
+      if (n <= 0)
+	return false;
+      p += n;
+      size -= n;
+    }
+  return true;
+}
+
+static void
+reloc_cache_write (void)
+{
+  struct reloc_cache_header header = { .magic = RELOC_CACHE_MAGIC };
+  header.flags = cache.flags;
+  header.nobjects = cache.nmaps;
+  header.nentries = cache.nrecord;
+  header.strsize = cache.strsize;
+
+  size_t objsize = cache.nmaps * sizeof (struct reloc_cache_object);
+  size_t strsize = ALIGN_UP (cache.strsize, 8);
+  size_t recsize = cache.nrecord * sizeof (struct reloc_cache_entry);
+  header.checksum = reloc_cache_checksum (0, cache.objects, objsize);
+  header.checksum = reloc_cache_checksum (header.checksum, cache.strings,
+					  strsize);
+  header.checksum = reloc_cache_checksum (header.checksum, cache.record,
+					  recsize);
+
+  size_t len = strlen (cache.file);
+  char *tmp = alloca (len + sizeof ".tmp");
+  __mempcpy (__mempcpy (tmp, cache.file, len), ".tmp", sizeof ".tmp");
+
+  int fd = __open64_nocancel (tmp, O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW
+			      | O_CLOEXEC, DEFFILEMODE);
+  if (fd == -1)
+    return;
+  bool ok = (reloc_cache_write_all (fd, &header, sizeof (header))
+	     && reloc_cache_write_all (fd, cache.objects, objsize)
+	     && reloc_cache_write_all (fd, cache.strings, strsize)
+	     && reloc_cache_write_all (fd, cache.record, recsize));
+  __close_nocancel (fd);
+
+  if (ok)
+#ifdef __NR_renameat
+    ok = INTERNAL_SYSCALL_CALL (renameat, AT_FDCWD, tmp,
+				AT_FDCWD, cache.file) == 0;
+#else
+    ok = INTERNAL_SYSCALL_CALL (renameat2, AT_FDCWD, tmp,
+				AT_FDCWD, cache.file, 0) == 0;
+#endif
+  if (!ok)
+    INTERNAL_SYSCALL_CALL (unlinkat, AT_FDCWD, tmp, 0);
+}
+
+void
+_dl_reloc_cache_finish (void)
+{
+  if (!_dl_reloc_cache_active)
+    return;
+  _dl_reloc_cache_active = 0;
+
+  /* If fewer lookups happened than recorded, the replayed ones are
+     still the complete list for this run.  */
+  if (!cache.recording && cache.next != cache.nreplay)
+    reloc_cache_diverge ();
+
+  uint32_t replayed = cache.recording ? 0 : cache.next;
+  if (cache.recording && !cache.failed)
+    reloc_cache_write ();
+
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_STATISTICS))
+    _dl_debug_printf ("relocation cache %s: %u lookups replayed, "
+		      "%u recorded\n", cache.file, replayed, cache.nrecord);
+
+  for (uint32_t i = 0; i < cache.nmaps; ++i)
+    cache.maps[i]->l_idx = 0;
+
+  if (cache.file_data != MAP_FAILED && cache.file_data != NULL)
+    __munmap (cache.file_data, cache.file_size);
+  if (cache.record != NULL)
+    __munmap (cache.record,
+	      cache.record_size * sizeof (struct reloc_cache_entry));
+}
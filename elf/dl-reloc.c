@@ -113,9 +113,10 @@ _dl_try_allocate_static_tls (struct link_map *map, bool optional)
 #ifdef SHARED
       if (__builtin_expect (THREAD_DTV()[0].counter != GL(dl_tls_generation),
 			    0))
-	/* Update the slot information data for at least the generation of
-	   the DSO we are allocating data for.  */
-	(void) _dl_update_slotinfo (map->l_tls_modid);
+	/* Update the slot information data for the current generation,
+	   which includes the DSO we are allocating data for.  */
+	(void) _dl_update_slotinfo (map->l_tls_modid,
+				    GL(dl_tls_generation));
 #endif
 
       dl_init_static_tls (map);
@@ -162,6 +163,26 @@ _dl_nothread_init_static_tls (struct link_map *map)
 }
 #endif /* !PTHREAD_IN_LIBC */
 
+/* Look up the symbol for a relocation, through the relocation cache
+   during the initial relocation if LD_RELOC_CACHE is set.  */
+static __always_inline lookup_t
+resolve_lookup (const char *undef_name, struct link_map *undef_map,
+		const ElfW(Sym) **ref, struct r_scope_elem *scope[],
+		const struct r_found_version *version, int type_class)
+{
+#ifdef SHARED
+  if (__glibc_unlikely (_dl_reloc_cache_active))
+    return _dl_reloc_cache_lookup (undef_name, undef_map, ref, scope,
+				   version, type_class,
+				   DL_LOOKUP_ADD_DEPENDENCY
+				   | DL_LOOKUP_FOR_RELOCATE);
+#endif
+  return _dl_lookup_symbol_x (undef_name, undef_map, ref, scope, version,
+			      type_class,
+			      DL_LOOKUP_ADD_DEPENDENCY | DL_LOOKUP_FOR_RELOCATE,
+			      NULL);
+}
+
 /* This macro is used as a callback from the ELF_DYNAMIC_RELOCATE code.  */
 #define RESOLVE_MAP(l, scope, ref, version, r_type)			      \
     ((ELFW(ST_BIND) ((*ref)->st_info) != STB_LOCAL			      \
@@ -178,10 +199,8 @@ _dl_nothread_init_static_tls (struct link_map *map)
 	     const struct r_found_version *v = NULL;			      \
 	     if ((version) != NULL && (version)->hash != 0)		      \
 	       v = (version);						      \
-	     _lr = _dl_lookup_symbol_x ((const char *) D_PTR (l, l_info[DT_STRTAB]) + (*ref)->st_name, \
-					l, (ref), scope, v, _tc,	      \
-					DL_LOOKUP_ADD_DEPENDENCY	      \
-					| DL_LOOKUP_FOR_RELOCATE, NULL);      \
+	     _lr = resolve_lookup ((const char *) D_PTR (l, l_info[DT_STRTAB]) + (*ref)->st_name, \
+				   l, (ref), scope, v, _tc);		      \
 	     l->l_lookup_cache.ret = (*ref);				      \
 	     l->l_lookup_cache.value = _lr; }))				      \
      : l)
@@ -216,6 +235,13 @@ _dl_relocate_object (struct link_map *l, struct r_scope_elem *scope[],
   if (l->l_relocated)
     return;
 
+#ifdef SHARED
+  struct dl_profile_start profile;
+  bool profiling = __glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_PROFILE);
+  if (profiling)
+    _dl_profile_start (&profile);
+#endif
+
   /* If DT_BIND_NOW is set relocate all references in this object.  We
      do not do this if we are profiling, of course.  */
   // XXX Correct for auditing?
@@ -318,6 +344,11 @@ _dl_relocate_object (struct link_map *l, struct r_scope_elem *scope[],
      done, do it.  */
   if (l->l_relro_size != 0)
     _dl_protect_relro (l);
+
+#ifdef SHARED
+  if (profiling)
+    _dl_profile_stop (&profile, l, dl_profile_reloc);
+#endif
 }
 
 
@@ -30,6 +30,9 @@
 #include <dl-irel.h>
 #include <dl-runtime.h>
 
+#define TUNABLE_NAMESPACE rtld
+#include <dl-tunables.h>
+
 
 #if (!ELF_MACHINE_NO_RELA && !defined ELF_MACHINE_PLT_REL) \
     || ELF_MACHINE_NO_REL
@@ -44,6 +47,93 @@
 # define ARCH_FIXUP_ATTRIBUTE
 #endif
 
+#ifdef ELF_MACHINE_PLT_BATCH
+/* Return true if the glibc.rtld.plt_batch tunable is set.  */
+static bool
+plt_batch_enabled (void)
+{
+# if HAVE_TUNABLES
+  static int enabled = -1;
+  if (enabled < 0)
+    enabled = TUNABLE_GET (plt_batch, int32_t, NULL);
+  return enabled > 0;
+# else
+  return false;
+# endif
+}
+
+/* Resolve the lazy PLT slots of L, other than the one for SKIP, which
+   refer to symbols with a version needed from the same file as
+   VERSION.  They are very likely bound to the object which has just
+   been found, so resolving them now saves a trip through the lazy
+   binding trampoline for each of them.  Slots whose symbol is not
+   defined or is an indirect function are left for their first call.
+   This is done only once for each file, so the slots left lazy are not
+   looked up again on every later call through the trampoline.  FLAGS
+   are the lookup flags of the caller, which holds the global scope.  */
+static void
+fixup_plt_batch (struct link_map *l, const PLTREL *skip,
+		 const struct r_found_version *version, int flags)
+{
+  if (__glibc_unlikely (GLRO(dl_bind_not)))
+    return;
+# ifdef SHARED
+  if (GLRO(dl_naudit) > 0)
+    return;
+# endif
+
+  const ElfW(Sym) *const symtab
+    = (const void *) D_PTR (l, l_info[DT_SYMTAB]);
+  const char *strtab = (const void *) D_PTR (l, l_info[DT_STRTAB]);
+  const ElfW(Half) *const vernum
+    = (const void *) D_PTR (l, l_info[VERSYMIDX (DT_VERSYM)]);
+  const PLTREL *reloc = (const void *) D_PTR (l, l_info[DT_JMPREL]);
+  const PLTREL *const end
+    = (const void *) ((const char *) reloc
+		      + l->l_info[DT_PLTRELSZ]->d_un.d_val);
+
+  for (; reloc < end; ++reloc)
+    {
+      if (reloc == skip
+	  || ELFW(R_TYPE) (reloc->r_info) != ELF_MACHINE_JMP_SLOT)
+	continue;
+
+      ElfW(Addr) *const rel_addr = (void *) (l->l_addr + reloc->r_offset);
+      if (!elf_machine_plt_lazy_p (l, rel_addr))
+	continue;
+
+      const ElfW(Sym) *sym = &symtab[ELFW(R_SYM) (reloc->r_info)];
+      if (ELFW(ST_VISIBILITY) (sym->st_other) != 0)
+	continue;
+
+      const struct r_found_version *symversion
+	= &l->l_versions[vernum[ELFW(R_SYM) (reloc->r_info)] & 0x7fff];
+      if (symversion->hash == 0 || symversion->filename != version->filename)
+	continue;
+
+      const ElfW(Sym) *const refsym = sym;
+      lookup_t result
+	= _dl_lookup_symbol_x (strtab + sym->st_name, l, &sym, l->l_scope,
+			       symversion, ELF_RTYPE_CLASS_PLT,
+			       flags | DL_LOOKUP_SPECULATIVE, NULL);
+      if (sym == NULL
+	  || ELFW(ST_TYPE) (sym->st_info) == STT_GNU_IFUNC)
+	continue;
+
+      DL_FIXUP_VALUE_TYPE value
+	= DL_FIXUP_MAKE_VALUE (result, SYMBOL_ADDRESS (result, sym, false));
+      value = elf_machine_plt_value (l, reloc, value);
+      elf_machine_fixup_plt (l, result, refsym, sym, reloc, rel_addr, value);
+    }
+
+  /* Concurrent calls may batch the same file twice, which is
+     harmless.  */
+  for (unsigned int i = 0; i < l->l_nversions; ++i)
+    if (l->l_versions[i].filename == version->filename)
+      atomic_store_relaxed (&l->l_versions[i].plt_batched, 1);
+}
+#endif
+
 /* This function is called through a special trampoline from the PLT the
    first time each PLT entry is called.  We must perform the relocation
    specified in the PLT of the given shared object, and return the resolved
@@ -110,6 +200,13 @@ _dl_fixup (
       result = _dl_lookup_symbol_x (strtab + sym->st_name, l, &sym, l->l_scope,
 				    version, ELF_RTYPE_CLASS_PLT, flags, NULL);
 
+#ifdef ELF_MACHINE_PLT_BATCH
+      if (sym != NULL && version != NULL && version->filename != NULL
+	  && !atomic_load_relaxed (&version->plt_batched)
+	  && plt_batch_enabled ())
+	fixup_plt_batch (l, reloc, version, flags);
+#endif
+
       /* We are done with the global scope.  */
       if (!RTLD_SINGLE_THREAD_P)
 	THREAD_GSCOPE_RESET_FLAG ();
@@ -51,7 +51,29 @@ _dl_scope_free (void *old)
       THREAD_GSCOPE_WAIT ();
       while (fsl->count > 0)
 	free (fsl->list[--fsl->count]);
+      free (old);
       return 1;
     }
   return 0;
 }
+
+
+int
+_dl_scope_reclaim (void)
+{
+  struct dl_scope_free_list *fsl = GL(dl_scope_free_list);
+
+  if (fsl == NULL || fsl->count == 0)
+    return 1;
+
+  /* The queued scopes have been replaced already.  Once no other
+     thread is in a lookup, none of them can be in use anymore.  This
+     does not wait for the threads which are, the scopes are freed by a
+     later call instead.  */
+  if (!RTLD_SINGLE_THREAD_P && !__thread_gscope_quiescent ())
+    return 0;
+
+  while (fsl->count > 0)
+    free (fsl->list[--fsl->count]);
+  return 1;
+}
@@ -16,16 +16,28 @@
    License along with the GNU C Library; if not, see
    <https://www.gnu.org/licenses/>.  */
 
+#include <assert.h>
 #include <ldsodefs.h>
 
+#if HAVE_TUNABLES
+# define TUNABLE_NAMESPACE rtld
+# include <dl-tunables.h>
+#endif
 
-/* Sort array MAPS according to dependencies of the contained objects.
-   Array USED, if non-NULL, is permutated along MAPS.  If FOR_FINI this is
-   called for finishing an object.  */
-void
-_dl_sort_maps (struct link_map **maps, unsigned int nmaps, char *used,
-	       bool for_fini)
+/* Note: this is the older, "original" sorting algorithm, which was the
+   default up to 2.34.
+
+   Sort array MAPS according to dependencies of the contained objects.
+   If FOR_FINI is true, this is called for finishing an object.  */
+static void
+_dl_sort_maps_original (struct link_map **maps, unsigned int nmaps,
+			bool force_first, bool for_fini)
 {
+  /* Allows caller to do the common optimization of skipping the first map,
+     usually the main binary.  */
+  maps += force_first;
+  nmaps -= force_first;
+
   /* A list of one element need not be sorted.  */
   if (nmaps <= 1)
     return;
@@ -66,14 +78,6 @@ _dl_sort_maps (struct link_map **maps, unsigned int nmaps, char *used,
 			   (k - i) * sizeof (maps[0]));
 		  maps[k] = thisp;
 
-		  if (used != NULL)
-		    {
-		      char here_used = used[i];
-		      memmove (&used[i], &used[i + 1],
-			       (k - i) * sizeof (used[0]));
-		      used[k] = here_used;
-		    }
-
 		  if (seen[i + 1] > nmaps - i)
 		    {
 		      ++i;
@@ -120,3 +124,177 @@ _dl_sort_maps (struct link_map **maps, unsigned int nmaps, char *used,
     next:;
     }
 }
+
+/* Visit MAP and all objects it depends on which have not been visited
+   yet, and store them in reverse postorder at the positions before
+   *RPO, which is decremented accordingly.  Relocation dependencies are
+   followed as well if DO_RELDEPS is not NULL, and *DO_RELDEPS is set
+   if any are found.
+
+   The recursion depth is bounded by the number of objects.
+   _dl_map_object_deps already uses stack space proportional to the
+   number of objects for the breadth-first search of dependencies.  */
+static void
+dfs_traversal (struct link_map ***rpo, struct link_map *map,
+	       bool *do_reldeps)
+{
+  /* _dl_map_object_deps ignores l_faked objects when calculating the
+     number of maps before calling _dl_sort_maps, ignore them as well.  */
+  if (map->l_visited || map->l_faked)
+    return;
+
+  map->l_visited = 1;
+
+  if (map->l_initfini)
+    {
+      for (int i = 0; map->l_initfini[i] != NULL; i++)
+	{
+	  struct link_map *dep = map->l_initfini[i];
+	  if (dep->l_visited == 0
+	      && dep->l_type != lt_executable)
+	    dfs_traversal (rpo, dep, do_reldeps);
+	}
+    }
+
+  if (__glibc_unlikely (do_reldeps != NULL && map->l_reldeps != NULL))
+    {
+      /* Indicate that we encountered relocation dependencies during
+	 traversal.  */
+      *do_reldeps = true;
+
+      for (int m = map->l_reldeps->act - 1; m >= 0; m--)
+	{
+	  struct link_map *dep = map->l_reldeps->list[m];
+	  if (dep->l_visited == 0
+	      && dep->l_type != lt_executable)
+	    dfs_traversal (rpo, dep, do_reldeps);
+	}
+    }
+
+  *rpo -= 1;
+  **rpo = map;
+}
+
+/* Topologically sort array MAPS according to dependencies of the
+   contained objects.  This takes time linear in the number of objects
+   and dependency links, while the original algorithm is cubic in the
+   worst case.  */
+static void
+_dl_sort_maps_dfs (struct link_map **maps, unsigned int nmaps,
+		   bool force_first, bool for_fini)
+{
+  struct link_map *first_map = maps[0];
+  for (int i = nmaps - 1; i >= 0; i--)
+    maps[i]->l_visited = 0;
+
+  /* We apply DFS traversal for each of maps[i] until the whole total
+     order is found and we are at the start of the reverse postorder
+     (RPO) sequence, which is a topological sort.
+
+     We go from maps[nmaps - 1] backwards towards maps[0] at this
+     level.  Due to the breadth-first ordering we receive, going
+     backwards usually gives a more shallow recursion depth.  Combined
+     with the natural processing order of l_initfini at each node this
+     also keeps the result closer to the original link order in simple
+     cases.
+
+     maps[0] is usually the object _dl_map_object_deps is processing,
+     and its l_initfini is still blank.  Starting the traversal from it
+     would place it last in the order.  Traversing it last avoids this.
+
+     Skipping maps[0] at the call site is not valid in general, because
+     following the dependency links may find it anyway, for example
+     through circular dependencies of a dlopen'ed object.  The full
+     list is passed, and FORCE_FIRST restores maps[0] afterwards.  */
+
+  /* Array to hold RPO sorting results, before we copy back to maps.  */
+  struct link_map *rpo[nmaps];
+
+  /* The head position during each DFS iteration.  Note that we start
+     at one past the last element due to first-decrement-then-store
+     (see the bottom of dfs_traversal).  */
+  struct link_map **rpo_head = &rpo[nmaps];
+
+  bool do_reldeps = false;
+  bool *do_reldeps_ref = (for_fini ? &do_reldeps : NULL);
+
+  for (int i = nmaps - 1; i >= 0; i--)
+    {
+      dfs_traversal (&rpo_head, maps[i], do_reldeps_ref);
+
+      /* We can break early if all objects are already placed.  */
+      if (rpo_head == rpo)
+	goto end;
+    }
+  assert (rpo_head == rpo);
+
+ end:
+  /* Here we may do a second pass of sorting, using only the l_initfini
+     static dependency links.  This is avoided if !FOR_FINI or if we did
+     not find any reldeps in the first DFS traversal.
+
+     While it is unspecified how circular dependencies should be
+     handled, the destructors should respect static dependency links
+     as much as possible, overriding reldeps if needed.  The first
+     pass, which takes l_initfini and l_reldeps links equally, may not
+     preserve this priority.  */
+  if (do_reldeps)
+    {
+      for (int i = nmaps - 1; i >= 0; i--)
+	rpo[i]->l_visited = 0;
+
+      struct link_map **maps_head = &maps[nmaps];
+      for (int i = nmaps - 1; i >= 0; i--)
+	{
+	  dfs_traversal (&maps_head, rpo[i], NULL);
+
+	  /* We can break early if all objects are already placed.  The
+	     results are written back to MAPS directly.  */
+	  if (maps_head == maps)
+	    break;
+	}
+      assert (maps_head == maps);
+    }
+  else
+    memcpy (maps, rpo, sizeof (struct link_map *) * nmaps);
+
+  /* Keep the main program or the object being loaded first if
+     requested.  */
+  if (force_first && maps[0] != first_map)
+    {
+      int i;
+      for (i = 1; maps[i] != first_map; ++i)
+	;
+      memmove (&maps[1], &maps[0], i * sizeof (maps[0]));
+      maps[0] = first_map;
+    }
+}
+
+#if HAVE_TUNABLES
+/* Return the value of glibc.rtld.dynamic_sort.  */
+static int32_t
+dynamic_sort (void)
+{
+  static int32_t algorithm;
+  if (algorithm == 0)
+    algorithm = TUNABLE_GET (dynamic_sort, int32_t, NULL);
+  return algorithm;
+}
+#endif
+
+void
+_dl_sort_maps (struct link_map **maps, unsigned int nmaps,
+	       bool force_first, bool for_fini)
+{
+  /* A list of one element need not be sorted, and neither does a list
+     of two elements of which the first one is kept in place.  */
+  if (nmaps <= 1 || (nmaps == 2 && force_first))
+    return;
+
+#if HAVE_TUNABLES
+  if (__glibc_unlikely (dynamic_sort () == 1))
+    _dl_sort_maps_original (maps, nmaps, force_first, for_fini);
+  else
+#endif
+    _dl_sort_maps_dfs (maps, nmaps, force_first, for_fini);
+}
@@ -75,6 +75,10 @@
 /* Default for dl_tls_static_optional.  */
 #define OPTIONAL_TLS 512
 
+/* Upper limit for dl_tls_static_optional when it is derived from the
+   TLS usage of the initially loaded modules.  */
+#define OPTIONAL_TLS_AUTO_MAX 16384
+
 /* Compute the static TLS surplus based on the namespace count and the
    TLS space that can be used for optimizations.  */
 static inline int
@@ -89,6 +93,39 @@ tls_static_surplus (int nns, int opt_tls)
    backwards compatibility.  */
 #define LEGACY_TLS (1664 - tls_static_surplus (DEFAULT_NNS, OPTIONAL_TLS))
 
+#if HAVE_TUNABLES
+/* Set if glibc.rtld.optional_static_tls was specified explicitly.  */
+static bool optional_tls_set;
+
+static void
+TUNABLE_CALLBACK (set_optional_static_tls) (tunable_val_t *valp)
+{
+  optional_tls_set = true;
+}
+#endif
+
+/* Return the amount of optional static TLS to reserve if it was not
+   specified explicitly.  Processes whose initially loaded modules use
+   a lot of TLS (for example C++ code with thread_local variables)
+   usually load plugins which do the same, so the reserve grows with
+   the TLS size of the initially loaded modules, up to
+   OPTIONAL_TLS_AUTO_MAX.  init_tls in rtld.c stores the initially
+   loaded modules from index 0 of the slotinfo list, as
+   _dl_determine_tlsoffset expects.  The list is not set up yet in
+   statically linked programs, which keep the default.  */
+static size_t
+optional_tls_auto (void)
+{
+  size_t total = 0;
+  struct dtv_slotinfo_list *listp = GL(dl_tls_dtv_slotinfo_list);
+  if (listp != NULL)
+    for (size_t cnt = 0; cnt < listp->len && listp->slotinfo[cnt].map != NULL;
+	 ++cnt)
+      total += listp->slotinfo[cnt].map->l_tls_blocksize;
+
+  return MAX (OPTIONAL_TLS, MIN (total, OPTIONAL_TLS_AUTO_MAX));
+}
+
 /* Calculate the size of the static TLS surplus, when the given
    number of audit modules are loaded.  Must be called after the
    number of audit modules is known and before static TLS allocation.  */
@@ -99,11 +136,14 @@ _dl_tls_static_surplus_init (size_t naudit)
 
 #if HAVE_TUNABLES
   nns = TUNABLE_GET (nns, size_t, NULL);
-  opt_tls = TUNABLE_GET (optional_static_tls, size_t, NULL);
+  opt_tls = TUNABLE_GET (optional_static_tls, size_t,
+			 TUNABLE_CALLBACK (set_optional_static_tls));
+  if (!optional_tls_set)
+    opt_tls = optional_tls_auto ();
 #else
-  /* Default values of the tunables.  */
+  /* Default value of the nns tunable.  */
   nns = DEFAULT_NNS;
-  opt_tls = OPTIONAL_TLS;
+  opt_tls = optional_tls_auto ();
 #endif
   if (nns > DL_NNS)
     nns = DL_NNS;
@@ -710,66 +750,57 @@ allocate_and_init (struct link_map *map)
 
 
 struct link_map *
-_dl_update_slotinfo (unsigned long int req_modid)
+_dl_update_slotinfo (unsigned long int req_modid, size_t new_gen)
 {
   struct link_map *the_map = NULL;
   dtv_t *dtv = THREAD_DTV ();
 
-  /* The global dl_tls_dtv_slotinfo array contains for each module
+  /* CONCURRENCY NOTES:
+
+     The global dl_tls_dtv_slotinfo array contains for each module
      index the generation counter current when the entry was created.
      This array never shrinks so that all module indices which were
      valid at some time can be used to access it.  Before the first
      use of a new module index in this function the array was extended
      appropriately.  Access also does not have to be guarded against
-     modifications of the array.  It is assumed that pointer-size
-     values can be read atomically even in SMP environments.  It is
-     possible that other threads at the same time dynamically load
-     code and therefore add to the slotinfo list.  This is a problem
-     since we must not pick up any information about incomplete work.
-     The solution to this is to ignore all dtv slots which were
-     created after the one we are currently interested.  We know that
-     dynamic loading for this module is completed and this is the last
-     load operation we know finished.  */
-  unsigned long int idx = req_modid;
-  struct dtv_slotinfo_list *listp = GL(dl_tls_dtv_slotinfo_list);
-
-  while (idx >= listp->len)
-    {
-      idx -= listp->len;
-      listp = listp->next;
-    }
-
-  if (dtv[0].counter < listp->slotinfo[idx].gen)
+     modifications of the array.
+
+     Here the dtv needs to be updated to new_gen generation count.
+     Callers pass the global generation counter, not only the
+     generation of the module being accessed, so that the dtv does not
+     stay behind it and the next TLS access takes the fast path.
+
+     This code may be called during TLS access when GL(dl_load_tls_lock)
+     is not held.  In that case the user code has to synchronize with
+     dlopen and dlclose calls of relevant modules.  A module m is
+     relevant if the generation of m <= new_gen and dlclose of m is
+     synchronized: a memory access here happens after the dlopen and
+     before the dlclose of relevant modules.  The dtv entries for
+     relevant modules need to be updated, other entries can be
+     arbitrary.
+
+     This e.g. means that the first part of the slotinfo list can be
+     accessed race free, but the tail may be concurrently extended.
+     Similarly relevant slotinfo entries can be read race free, but
+     other entries are racy.  However updating a non-relevant dtv
+     entry does not affect correctness.  For a relevant module m,
+     max_modid >= modid of m.  */
+  if (dtv[0].counter < new_gen)
     {
-      /* CONCURRENCY NOTES:
-
-	 Here the dtv needs to be updated to new_gen generation count.
-
-	 This code may be called during TLS access when GL(dl_load_tls_lock)
-	 is not held.  In that case the user code has to synchronize with
-	 dlopen and dlclose calls of relevant modules.  A module m is
-	 relevant if the generation of m <= new_gen and dlclose of m is
-	 synchronized: a memory access here happens after the dlopen and
-	 before the dlclose of relevant modules.  The dtv entries for
-	 relevant modules need to be updated, other entries can be
-	 arbitrary.
-
-	 This e.g. means that the first part of the slotinfo list can be
-	 accessed race free, but the tail may be concurrently extended.
-	 Similarly relevant slotinfo entries can be read race free, but
-	 other entries are racy.  However updating a non-relevant dtv
-	 entry does not affect correctness.  For a relevant module m,
-	 max_modid >= modid of m.  */
-      size_t new_gen = listp->slotinfo[idx].gen;
       size_t total = 0;
       size_t max_modid  = atomic_load_relaxed (&GL(dl_tls_max_dtv_idx));
       assert (max_modid >= req_modid);
 
       /* We have to look through the entire dtv slotinfo list.  */
-      listp =  GL(dl_tls_dtv_slotinfo_list);
+      struct dtv_slotinfo_list *listp = GL(dl_tls_dtv_slotinfo_list);
       do
 	{
-	  for (size_t cnt = total == 0 ? 1 : 0; cnt < listp->len; ++cnt)
+	  /* List elements without entries newer than the current dtv
+	     layout need not be looked at.  This keeps the update cheap
+	     when many modules with TLS are loaded.  */
+	  size_t len = (atomic_load_relaxed (&listp->gen) > dtv[0].counter
+			? listp->len : 0);
+	  for (size_t cnt = total == 0 ? 1 : 0; cnt < len; ++cnt)
 	    {
 	      size_t modid = total + cnt;
 
@@ -903,9 +934,9 @@ tls_get_addr_tail (GET_ADDR_ARGS, dtv_t *dtv, struct link_map *the_map)
 
 static struct link_map *
 __attribute_noinline__
-update_get_addr (GET_ADDR_ARGS)
+update_get_addr (GET_ADDR_ARGS, size_t gen)
 {
-  struct link_map *the_map = _dl_update_slotinfo (GET_ADDR_MODULE);
+  struct link_map *the_map = _dl_update_slotinfo (GET_ADDR_MODULE, gen);
   dtv_t *dtv = THREAD_DTV ();
 
   void *p = dtv[GET_ADDR_MODULE].pointer.val;
@@ -935,12 +966,18 @@ __tls_get_addr (GET_ADDR_ARGS)
   dtv_t *dtv = THREAD_DTV ();
 
   /* Update is needed if dtv[0].counter < the generation of the accessed
-     module.  The global generation counter is used here as it is easier
-     to check.  Synchronization for the relaxed MO access is guaranteed
-     by user code, see CONCURRENCY NOTES in _dl_update_slotinfo.  */
+     module, but the global generation counter is checked here as it is
+     easier to check.  Synchronization for the relaxed MO access is
+     guaranteed by user code, see CONCURRENCY NOTES in
+     _dl_update_slotinfo.  */
   size_t gen = atomic_load_relaxed (&GL(dl_tls_generation));
   if (__glibc_unlikely (dtv[0].counter != gen))
-    return update_get_addr (GET_ADDR_PARAM);
+    {
+      /* Update the dtv up to the global generation, see CONCURRENCY
+	 NOTES in _dl_update_slotinfo.  */
+      gen = atomic_load_acquire (&GL(dl_tls_generation));
+      return update_get_addr (GET_ADDR_PARAM, gen);
+    }
 
   void *p = dtv[GET_ADDR_MODULE].pointer.val;
 
@@ -1041,6 +1078,7 @@ cannot create TLS data structures"));
 	}
 
       listp->len = TLS_SLOTINFO_SURPLUS;
+      listp->gen = 0;
       listp->next = NULL;
       memset (listp->slotinfo, '\0',
 	      TLS_SLOTINFO_SURPLUS * sizeof (struct dtv_slotinfo));
@@ -1055,6 +1093,7 @@ cannot create TLS data structures"));
       atomic_store_relaxed (&listp->slotinfo[idx].map, l);
       atomic_store_relaxed (&listp->slotinfo[idx].gen,
 			    GL(dl_tls_generation) + 1);
+      atomic_store_relaxed (&listp->gen, GL(dl_tls_generation) + 1);
     }
 }
 
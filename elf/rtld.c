@@ -35,6 +35,7 @@
 #include <dl-librecon.h>
 #include <unsecvars.h>
 #include <dl-cache.h>
+#include <dl-dircache.h>
 #include <dl-osinfo.h>
 #include <dl-procinfo.h>
 #include <dl-prop.h>
@@ -301,6 +302,7 @@ dl_main_state_init (struct dl_main_state *state)
   state->preloadarg = NULL;
   state->glibc_hwcaps_prepend = NULL;
   state->glibc_hwcaps_mask = NULL;
+  state->reloc_cache = NULL;
   state->mode = rtld_mode_normal;
   state->any_debug = false;
   state->version_info = false;
@@ -506,6 +508,15 @@ _dl_start_final (void *arg, struct dl_start_final_info *info)
       print_statistics (RTLD_TIMING_REF(rtld_total_time));
     }
 
+#if HP_TIMING_INLINE
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_PROFILE))
+    {
+      hp_timing_t rtld_total_time;
+      rtld_timer_stop (&rtld_total_time, start_time);
+      _dl_profile_rtld_times (rtld_total_time, load_time, relocate_time);
+    }
+#endif
+
   return start_addr;
 }
 
@@ -2365,6 +2376,17 @@ dl_main (const ElfW(Phdr) *phdr,
 
       RTLD_TIMING_VAR (start);
       rtld_timer_start (&start);
+
+      /* Replay or record the symbol bindings if LD_RELOC_CACHE is set.
+	 Auditing and binding debug output need the real lookups.  */
+      bool reloc_cache = (state.reloc_cache != NULL
+			  && state.mode == rtld_mode_normal
+			  && GLRO(dl_naudit) == 0
+			  && !(GLRO(dl_debug_mask) & DL_DEBUG_BINDINGS));
+      if (reloc_cache)
+	_dl_reloc_cache_setup (state.reloc_cache);
+      _dl_lookup_memo_start ();
+
       unsigned i = main_map->l_searchlist.r_nlist;
       while (i-- > 0)
 	{
@@ -2391,6 +2413,11 @@ dl_main (const ElfW(Phdr) *phdr,
 	  if (l->l_tls_blocksize != 0 && tls_init_tp_called)
 	    _dl_add_to_slotinfo (l, true);
 	}
+
+      _dl_lookup_memo_end ();
+      if (reloc_cache)
+	_dl_reloc_cache_finish ();
+
       rtld_timer_stop (&relocate_time, start);
 
       /* Now enable profiling if needed.  Like the previous call,
@@ -2498,6 +2525,9 @@ dl_main (const ElfW(Phdr) *phdr,
   _dl_unload_cache ();
 #endif
 
+  /* The program may change the directories which were searched.  */
+  _dl_dircache_release ();
+
   /* Once we return, _dl_sysdep_start will invoke
      the DT_INIT functions and then *USER_ENTRY.  */
 }
@@ -2559,6 +2589,8 @@ process_dl_debug (struct dl_main_state *state, const char *dl_debug)
 	| DL_DEBUG_SCOPES },
       { LEN_AND_STR ("statistics"), "display relocation statistics",
 	DL_DEBUG_STATISTICS },
+      { LEN_AND_STR ("profile"), "display a JSON startup profile",
+	DL_DEBUG_PROFILE },
       { LEN_AND_STR ("unused"), "determined unused DSOs",
 	DL_DEBUG_UNUSED },
       { LEN_AND_STR ("help"), "display this help message and exit",
@@ -2725,7 +2757,16 @@ process_envvars (struct dl_main_state *state)
 	  /* Path where the binary is found.  */
 	  if (!__libc_enable_secure
 	      && memcmp (envline, "ORIGIN_PATH", 11) == 0)
-	    GLRO(dl_origin_path) = &envline[12];
+	    {
+	      GLRO(dl_origin_path) = &envline[12];
+	      break;
+	    }
+
+	  /* File caching the symbol bindings of the initial relocation.  */
+	  if (!__libc_enable_secure
+	      && memcmp (envline, "RELOC_CACHE", 11) == 0
+	      && envline[12] != '\0')
+	    state->reloc_cache = &envline[12];
 	  break;
 
 	case 12:
@@ -0,0 +1,5 @@
+int
+dep1 (void)
+{
+  return 1;
+}
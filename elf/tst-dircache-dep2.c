@@ -0,0 +1,5 @@
+int
+dep2 (void)
+{
+  return 2;
+}
@@ -0,0 +1,5 @@
+int
+dep3 (void)
+{
+  return 3;
+}
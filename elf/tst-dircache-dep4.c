@@ -0,0 +1,5 @@
+int
+dep4 (void)
+{
+  return 4;
+}
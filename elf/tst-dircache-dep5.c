@@ -0,0 +1,5 @@
+int
+dep5 (void)
+{
+  return 5;
+}
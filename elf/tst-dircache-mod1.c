@@ -0,0 +1,11 @@
+extern int dep1 (void);
+extern int dep2 (void);
+extern int dep3 (void);
+extern int dep4 (void);
+extern int dep5 (void);
+
+int
+sum (void)
+{
+  return dep1 () + dep2 () + dep3 () + dep4 () + dep5 ();
+}
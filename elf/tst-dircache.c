@@ -0,0 +1,90 @@
+/* Test that the directory cache does not hide new shared objects.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xdlfcn.h>
+#include <support/xunistd.h>
+
+/* tst-dircache-mod1.so depends on libtst-dircache-dep1.so to
+   libtst-dircache-dep5.so, which are searched for in its RUNPATH
+   directory.  The directory is searched often enough to be read by
+   the dynamic linker.  */
+#define NDEPS 5
+
+static char *dir;
+
+static char *
+dep_path (int i)
+{
+  return xasprintf ("%s/libtst-dircache-dep%d.so", dir, i);
+}
+
+static void
+install_dep (int i)
+{
+  char *src = xasprintf ("%s/elf/tst-dircache-dep%d.so",
+			 support_objdir_root, i);
+  char *dst = dep_path (i);
+  support_copy_file (src, dst);
+  free (dst);
+  free (src);
+}
+
+static int
+do_test (void)
+{
+  dir = xasprintf ("%s/elf/tst-dircache-dir", support_objdir_root);
+  xmkdirp (dir, 0777);
+  for (int i = 1; i <= NDEPS; ++i)
+    {
+      char *path = dep_path (i);
+      if (unlink (path) != 0 && errno != ENOENT)
+	FAIL_EXIT1 ("unlink (\"%s\"): %m", path);
+      free (path);
+    }
+
+  /* The last dependency is missing.  By the time it is searched for,
+     the directory contents are cached.  */
+  for (int i = 1; i < NDEPS; ++i)
+    install_dep (i);
+  TEST_VERIFY (dlopen ("tst-dircache-mod1.so", RTLD_NOW) == NULL);
+
+  /* The contents are not kept across dlopen calls, so the dependency
+     is found once it is installed.  */
+  install_dep (NDEPS);
+  void *mod1 = xdlopen ("tst-dircache-mod1.so", RTLD_NOW);
+  int (*sum) (void) = xdlsym (mod1, "sum");
+  TEST_COMPARE (sum (), 1 + 2 + 3 + 4 + 5);
+  xdlclose (mod1);
+
+  for (int i = 1; i <= NDEPS; ++i)
+    {
+      char *path = dep_path (i);
+      xunlink (path);
+      free (path);
+    }
+  free (dir);
+  return 0;
+}
+
+#include <support/test-driver.c>
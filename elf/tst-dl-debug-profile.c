@@ -0,0 +1,134 @@
+/* Test the JSON startup profile written with LD_DEBUG=profile.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The test runs with LD_DEBUG=profile and LD_DEBUG_OUTPUT set, so the
+   dynamic linker has written the profile to LD_DEBUG_OUTPUT.PID
+   before main was called.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xstdio.h>
+
+extern const char *profile_mod_name (void);
+
+/* Return the contents of the profile written by the process PID, or
+   NULL if there is no such file.  */
+static char *
+read_profile (pid_t pid)
+{
+  char *path = xasprintf ("%s.%d", getenv ("LD_DEBUG_OUTPUT"), (int) pid);
+  FILE *fp = fopen (path, "r");
+  free (path);
+  if (fp == NULL)
+    return NULL;
+  char *contents = NULL;
+  size_t size = 0;
+  TEST_VERIFY (getdelim (&contents, &size, '\0', fp) > 0);
+  xfclose (fp);
+  return contents;
+}
+
+/* Check that the braces and brackets outside of strings in S are
+   balanced.  */
+static void
+check_nesting (const char *s)
+{
+  char stack[16];
+  int depth = 0;
+  bool in_string = false;
+  for (; *s != '\0'; ++s)
+    if (in_string)
+      {
+	if (*s == '\\')
+	  ++s;
+	else if (*s == '"')
+	  in_string = false;
+      }
+    else if (*s == '"')
+      in_string = true;
+    else if (*s == '{' || *s == '[')
+      {
+	TEST_VERIFY_EXIT (depth < (int) sizeof (stack));
+	stack[depth++] = *s == '{' ? '}' : ']';
+      }
+    else if (*s == '}' || *s == ']')
+      {
+	TEST_VERIFY_EXIT (depth > 0);
+	TEST_COMPARE (stack[--depth], *s);
+      }
+  TEST_COMPARE (depth, 0);
+  TEST_VERIFY (!in_string);
+}
+
+/* Return the value of the member NAME in the object starting at
+   OBJECT.  */
+static unsigned long int
+member (const char *object, const char *name)
+{
+  char *key = xasprintf ("\"%s\": ", name);
+  const char *p = strstr (object, key);
+  const char *end = strchr (object, '}');
+  TEST_VERIFY_EXIT (p != NULL && p < end);
+  unsigned long int value = strtoul (p + strlen (key), NULL, 10);
+  free (key);
+  return value;
+}
+
+static int
+do_test (void)
+{
+  TEST_COMPARE_STRING (profile_mod_name (), "tst-dl-debug-profile-mod");
+
+  /* The test driver runs the test in a subprocess.  */
+  char *profile = read_profile (getppid ());
+  if (profile == NULL)
+    profile = read_profile (getpid ());
+  TEST_VERIFY_EXIT (profile != NULL);
+
+  TEST_VERIFY (strncmp (profile, "{\n", 2) == 0);
+  TEST_VERIFY (strcmp (profile + strlen (profile) - 2, "}\n") == 0);
+  check_nesting (profile);
+  TEST_VERIFY (strstr (profile, "\"objects\": [") != NULL);
+  TEST_VERIFY (member (profile, "relocations") > 0);
+
+  /* The module has been mapped, relocated and initialized.  */
+  const char *object = strstr (profile, "tst-dl-debug-profile-mod.so\"");
+  TEST_VERIFY_EXIT (object != NULL);
+  TEST_VERIFY (member (object, "lookups") > 0);
+  member (object, "map_faults");
+  member (object, "init_faults");
+  member (object, "failed_probes");
+#if defined __x86_64__ || defined __i386__
+  /* These architectures support hp-timing.  */
+  TEST_VERIFY (member (object, "map_time") > 0);
+  TEST_VERIFY (member (object, "relocate_time") > 0);
+  TEST_VERIFY (member (object, "init_time") > 0);
+#endif
+
+  /* libc.so.6 is listed as well.  */
+  TEST_VERIFY (strstr (profile, "libc.so.6\"") != NULL);
+
+  free (profile);
+  return 0;
+}
+
+#include <support/test-driver.c>
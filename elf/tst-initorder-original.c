@@ -0,0 +1 @@
+#include "tst-initorder.c"
@@ -0,0 +1,90 @@
+/* Test lookups through the name index in /etc/ld.so.cache.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xdlfcn.h>
+#include <support/xunistd.h>
+
+/* Invoke /sbin/ldconfig with some error checking.  */
+static void
+run_ldconfig (void)
+{
+  char *command = xasprintf ("%s/ldconfig", support_install_rootsbindir);
+  TEST_COMPARE (system (command), 0);
+  free (command);
+}
+
+/* Install libmarkermodINDEX-1.so under its soname.  */
+static void
+install_marker (int index)
+{
+  char *src = xasprintf ("%s/elf/libmarkermod%d-1.so",
+                         support_objdir_root, index);
+  char *dst = xasprintf ("/glibc-test/lib/libmarkermod%d.so", index);
+  support_copy_file (src, dst);
+  free (dst);
+  free (src);
+}
+
+/* Load SONAME and check that markerINDEX returns EXPECTED.  */
+static void
+check_marker (const char *soname, int index, int expected)
+{
+  void *handle = xdlopen (soname, RTLD_NOW);
+  char *symbol = xasprintf ("marker%d", index);
+  int (*marker) (void) = xdlsym (handle, symbol);
+  TEST_COMPARE (marker (), expected);
+  free (symbol);
+  xdlclose (handle);
+}
+
+static int
+do_test (void)
+{
+  xmkdirp ("/etc", 0777);
+  support_write_file_string ("/etc/ld.so.conf", "/glibc-test/lib\n");
+  xmkdirp ("/glibc-test/lib", 0777);
+  for (int i = 1; i <= 4; ++i)
+    install_marker (i);
+  run_ldconfig ();
+
+  /* Every installed soname is found through the index.  */
+  check_marker ("libmarkermod1.so", 1, 1);
+  check_marker ("libmarkermod2.so", 2, 1);
+  check_marker ("libmarkermod3.so", 3, 1);
+  check_marker ("libmarkermod4.so", 4, 1);
+
+  /* _dl_cache_libcmp compares digit runs numerically, so the index
+     hash must treat "01" and "1" as the same name.  */
+  check_marker ("libmarkermod01.so", 1, 1);
+  check_marker ("libmarkermod004.so", 4, 1);
+
+  /* Names absent from the cache hit an empty slot and fail.  */
+  TEST_VERIFY (dlopen ("libmarkermod5.so", RTLD_NOW) == NULL);
+  TEST_VERIFY (dlopen ("libmarkermod10.so", RTLD_NOW) == NULL);
+  TEST_VERIFY (dlopen ("libnonexistent-name-index.so", RTLD_NOW) == NULL);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,32 @@
+/* Module for the LD_RELOC_CACHE test.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+extern int reloc_cache_var;
+
+/* Interposed by the definition in tst-reloc-cache-mod1.so.  */
+int
+reloc_cache_interposed (void)
+{
+  return 2;
+}
+
+int
+reloc_cache_mod2 (void)
+{
+  return reloc_cache_interposed () + reloc_cache_var;
+}
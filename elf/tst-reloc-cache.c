@@ -0,0 +1,41 @@
+/* Check the symbol bindings, with or without LD_RELOC_CACHE.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <support/check.h>
+
+extern int reloc_cache_var;
+extern int reloc_cache_interposed (void);
+extern int reloc_cache_mod2 (void);
+extern int reloc_cache_missing (void) __attribute__ ((weak));
+
+static int
+do_test (void)
+{
+  TEST_COMPARE (reloc_cache_var, 42);
+  TEST_COMPARE (reloc_cache_interposed (), 1);
+  TEST_COMPARE (reloc_cache_mod2 (), 43);
+  TEST_VERIFY (&reloc_cache_missing == NULL);
+
+  /* The module must use the same variable.  */
+  reloc_cache_var = 1;
+  TEST_COMPARE (reloc_cache_mod2 (), 2);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,73 @@
+#!/bin/sh
+# Test the LD_RELOC_CACHE relocation cache of ld.so.
+# Copyright (C) 2021 Free Software Foundation, Inc.
+# This file is part of the GNU C Library.
+#
+# The GNU C Library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# The GNU C Library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with the GNU C Library; if not, see
+# <https://www.gnu.org/licenses/>.
+
+set -e
+
+rtld=$1
+test_program=$2
+test_wrapper_env=$3
+run_program_env=$4
+library_path=$5
+cache=$6
+
+# Run the test program with the cache and print the cache statistics.
+run ()
+{
+  echo "# LD_BIND_NOW=$1"
+  ${test_wrapper_env} \
+  ${run_program_env} \
+  LD_RELOC_CACHE=$cache LD_BIND_NOW=$1 LD_DEBUG=statistics \
+  $rtld --library-path "$library_path" $test_program 2> $cache.err
+  cat $cache.err
+  stats=$(grep -o '[0-9]* lookups replayed, [0-9]* recorded' $cache.err)
+}
+
+fail ()
+{
+  echo "FAIL: $1"
+  exit 1
+}
+
+rm -f $cache $cache.tmp
+
+# The first run records the lookups and writes the cache.
+run 1
+case $stats in
+  "0 lookups replayed, 0 recorded"|"") fail "nothing recorded" ;;
+  "0 lookups replayed, "*) ;;
+  *) fail "unexpected replay" ;;
+esac
+test -f $cache || fail "cache not written"
+
+# The second run replays them.
+run 1
+case $stats in
+  "0 lookups replayed, "*|"") fail "nothing replayed" ;;
+  *" 0 recorded") ;;
+  *) fail "unexpected recording" ;;
+esac
+
+# Lazy binding does different lookups, so the cache is rewritten.
+run ""
+case $stats in
+  "0 lookups replayed, "*) ;;
+  *) fail "outdated cache used" ;;
+esac
+
+rm -f $cache $cache.err
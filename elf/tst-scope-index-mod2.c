@@ -0,0 +1,34 @@
+/* Module for the global scope symbol index test.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Only defined by tst-scope-index-mod1.so, which is not a dependency
+   of this module and has to be found in the global scope.  */
+extern int scope_index_mod1 (void);
+
+/* Interposed by the definition in tst-scope-index-mod1.so.  */
+int
+scope_index_sym (void)
+{
+  return 2;
+}
+
+int
+scope_index_mod2 (void)
+{
+  return scope_index_mod1 () + scope_index_sym ();
+}
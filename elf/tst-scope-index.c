@@ -0,0 +1,82 @@
+/* Test symbol lookups with the global scope symbol index.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <stddef.h>
+#include <support/check.h>
+#include <support/xdlfcn.h>
+
+/* The test runs with glibc.rtld.scope_index_min=1, so the index of the
+   global scope is built while the program is relocated and has to be
+   kept up to date by dlopen and dlclose.  Successful lookups use the
+   handles, so that the objects do not become NODELETE.  */
+
+static int
+call (void *handle, const char *name)
+{
+  int (*func) (void) = xdlsym (handle, name);
+  return func ();
+}
+
+static int
+do_test (void)
+{
+  TEST_VERIFY (dlsym (RTLD_DEFAULT, "scope_index_sym") == NULL);
+  TEST_VERIFY (dlsym (RTLD_DEFAULT, "scope_index_mod1") == NULL);
+
+  void *h1 = xdlopen ("tst-scope-index-mod1.so", RTLD_NOW | RTLD_GLOBAL);
+  TEST_COMPARE (call (h1, "scope_index_sym"), 1);
+
+  /* The relocation of the second module needs the symbols of the first
+     one from the global scope, which also interpose its own.  */
+  void *h2 = xdlopen ("tst-scope-index-mod2.so", RTLD_NOW | RTLD_GLOBAL);
+  TEST_COMPARE (call (h2, "scope_index_mod2"), 2);
+  TEST_COMPARE (call (h2, "scope_index_sym"), 2);
+
+  xdlclose (h2);
+  TEST_VERIFY (dlsym (RTLD_DEFAULT, "scope_index_mod2") == NULL);
+  TEST_COMPARE (call (h1, "scope_index_mod1"), 1);
+
+  /* The second module was removed from the end of the global scope,
+     and its symbols from the existing index.  Adding it again has to
+     add them back.  */
+  h2 = xdlopen ("tst-scope-index-mod2.so", RTLD_NOW | RTLD_GLOBAL);
+  TEST_COMPARE (call (h2, "scope_index_mod2"), 2);
+  TEST_COMPARE (call (h2, "scope_index_sym"), 2);
+  xdlclose (h2);
+  TEST_VERIFY (dlsym (RTLD_DEFAULT, "scope_index_mod2") == NULL);
+
+  xdlclose (h1);
+  TEST_VERIFY (dlsym (RTLD_DEFAULT, "scope_index_sym") == NULL);
+  TEST_VERIFY (dlsym (RTLD_DEFAULT, "scope_index_mod1") == NULL);
+
+  /* Without the first module in the global scope the second one cannot
+     be relocated.  */
+  TEST_VERIFY (dlopen ("tst-scope-index-mod2.so", RTLD_NOW) == NULL);
+
+  h1 = xdlopen ("tst-scope-index-mod1.so", RTLD_NOW | RTLD_GLOBAL);
+  h2 = xdlopen ("tst-scope-index-mod2.so", RTLD_NOW);
+  TEST_COMPARE (call (h2, "scope_index_mod2"), 2);
+  TEST_VERIFY (dlsym (RTLD_DEFAULT, "scope_index_mod2") == NULL);
+  xdlclose (h2);
+  xdlclose (h1);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
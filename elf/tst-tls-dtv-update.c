@@ -0,0 +1,129 @@
+/* Test dtv updates of a thread after dlopen and dlclose.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The thread is created before the modules are loaded, so its dtv is
+   brought up to date by __tls_get_addr.  After dlclose and dlopen of a
+   module, the module usually gets the same module ID again, and the
+   thread has to see a freshly initialized TLS block for it while the
+   TLS block of the other module stays untouched.  */
+
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <support/check.h>
+#include <support/xdlfcn.h>
+#include <support/xthread.h>
+
+static pthread_barrier_t barrier;
+
+/* The function run by the thread, NULL to terminate it.  */
+static void (*task) (void);
+
+static int *(*get_var1) (void);
+static int *(*get_var2) (void);
+
+static void *
+thread_func (void *closure)
+{
+  while (true)
+    {
+      xpthread_barrier_wait (&barrier);
+      if (task == NULL)
+	return NULL;
+      task ();
+      xpthread_barrier_wait (&barrier);
+    }
+}
+
+/* Run F in the thread and wait for it to finish.  */
+static void
+run_in_thread (void (*f) (void))
+{
+  task = f;
+  xpthread_barrier_wait (&barrier);
+  xpthread_barrier_wait (&barrier);
+}
+
+static int *var1_addr;
+
+static void
+init_var1 (void)
+{
+  var1_addr = get_var1 ();
+  TEST_COMPARE (*var1_addr, 1);
+  *var1_addr = 10;
+}
+
+static void
+check_var1 (void)
+{
+  TEST_VERIFY (get_var1 () == var1_addr);
+  TEST_COMPARE (*get_var1 (), 10);
+}
+
+static void
+use_var2 (void)
+{
+  /* The module has just been loaded, so the variable has its
+     initial value.  */
+  TEST_COMPARE (*get_var2 (), 2);
+  *get_var2 () = 20;
+  TEST_COMPARE (*get_var1 (), 10);
+}
+
+static void *
+load_mod2 (void)
+{
+  void *h = xdlopen ("tst-tls-dtv-update-mod2.so", RTLD_NOW);
+  get_var2 = xdlsym (h, "get_var");
+  return h;
+}
+
+static int
+do_test (void)
+{
+  xpthread_barrier_init (&barrier, NULL, 2);
+  pthread_t thr = xpthread_create (NULL, thread_func, NULL);
+
+  void *h1 = xdlopen ("tst-tls-dtv-update-mod1.so", RTLD_NOW);
+  get_var1 = xdlsym (h1, "get_var");
+  run_in_thread (init_var1);
+  TEST_COMPARE (*get_var1 (), 1);
+
+  for (int i = 0; i < 100; ++i)
+    {
+      void *h2 = load_mod2 ();
+      run_in_thread (use_var2);
+      run_in_thread (check_var1);
+      TEST_COMPARE (*get_var2 (), 2);
+      xdlclose (h2);
+
+      /* Only the TLS block of the unloaded module may be reset.  */
+      run_in_thread (check_var1);
+    }
+
+  task = NULL;
+  xpthread_barrier_wait (&barrier);
+  xpthread_join (thr);
+  xdlclose (h1);
+  xpthread_barrier_destroy (&barrier);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
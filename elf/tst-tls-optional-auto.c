@@ -0,0 +1,45 @@
+/* Test that the optional static TLS reserve covers the main program.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The main program is the first module with TLS, and its TLS is larger
+   than the default reserve.  Unless the reserve derived from it is used,
+   the module loaded with dlopen does not fit into static TLS.  */
+
+#include <support/check.h>
+#include <support/xdlfcn.h>
+
+#define TLS_SIZE 8192
+
+__thread char main_var[TLS_SIZE];
+
+static int
+do_test (void)
+{
+  main_var[TLS_SIZE - 1] = 1;
+
+  void *h = xdlopen ("tst-tls-optional-auto-mod.so", RTLD_NOW);
+  char *(*get_var) (void) = xdlsym (h, "get_var");
+  char *var = get_var ();
+  var[TLS_SIZE - 1] = 2;
+  TEST_COMPARE (main_var[TLS_SIZE - 1], 1);
+  xdlclose (h);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
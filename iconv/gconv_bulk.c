@@ -0,0 +1,55 @@
+/* Bulk conversion between UTF-8 and INTERNAL.  Generic version.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <stdint.h>
+#include <string.h>
+
+/* Eight characters are checked at once, with one 64-bit word of UTF-8
+   input or with the OR of eight INTERNAL characters.  */
+#define ASCII_BLOCK 8
+
+static __always_inline size_t
+ascii_to_internal (const unsigned char *in, unsigned char *out)
+{
+  uint64_t word;
+  memcpy (&word, in, sizeof (word));
+  if ((word & 0x8080808080808080ULL) != 0)
+    return 0;
+  for (int i = 0; i < ASCII_BLOCK; i++)
+    ((uint32_t *) out)[i] = in[i];
+  return ASCII_BLOCK;
+}
+
+static __always_inline size_t
+internal_to_ascii (const unsigned char *in, unsigned char *out)
+{
+  const uint32_t *win = (const uint32_t *) in;
+  uint32_t any = 0;
+  for (int i = 0; i < ASCII_BLOCK; i++)
+    any |= win[i];
+  if (any >= 0x80)
+    return 0;
+  for (int i = 0; i < ASCII_BLOCK; i++)
+    out[i] = win[i];
+  return ASCII_BLOCK;
+}
+
+#define BULK_UTF8_INTERNAL __gconv_bulk_utf8_internal
+#define BULK_INTERNAL_UTF8 __gconv_bulk_internal_utf8
+
+#include <iconv/gconv_bulk.h>
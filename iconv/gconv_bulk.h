@@ -0,0 +1,224 @@
+/* Bulk conversion between UTF-8 and INTERNAL.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* This file is included by the implementations of
+   __gconv_bulk_utf8_internal and __gconv_bulk_internal_utf8, which
+   define:
+
+     BULK_UTF8_INTERNAL	 the name of the UTF-8 to INTERNAL function.
+     BULK_INTERNAL_UTF8	 the name of the INTERNAL to UTF-8 function.
+     ASCII_BLOCK	 the number of characters converted at once.
+
+   and the functions
+
+     size_t ascii_to_internal (const unsigned char *in, unsigned char *out)
+     size_t internal_to_ascii (const unsigned char *in, unsigned char *out)
+
+   which convert the ASCII characters among the ASCII_BLOCK characters
+   at IN up to the first non-ASCII one, or some of them, to OUT and
+   return their number.  They must not write to OUT past the converted
+   characters.
+
+   Only the characters which the conversion loops in gconv_simple.c
+   convert the same way for all flags are handled here: ASCII, and the
+   well-formed sequences of two to four bytes for characters up to
+   0x10ffff other than surrogates.  */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <iconv/gconv_int.h>
+
+/* Decode the UTF-8 sequence of two to four bytes at *INPTRP, which
+   starts with a byte of at least 0x80.  Return false if it is not
+   complete, or not one of the sequences handled here.  */
+static __always_inline bool
+utf8_decode (const unsigned char **inptrp, const unsigned char *inend,
+	     uint32_t *wcp)
+{
+  const unsigned char *p = *inptrp;
+  size_t avail = inend - p;
+  uint32_t wc = p[0];
+
+  if (wc >= 0xc2 && wc < 0xe0)
+    {
+      if (avail < 2 || (p[1] & 0xc0) != 0x80)
+	return false;
+      wc = ((wc & 0x1f) << 6) | (p[1] & 0x3f);
+      *inptrp = p + 2;
+    }
+  else if ((wc & 0xf0) == 0xe0)
+    {
+      if (avail < 3 || (p[1] & 0xc0) != 0x80 || (p[2] & 0xc0) != 0x80)
+	return false;
+      wc = ((wc & 0x0f) << 12) | ((p[1] & 0x3f) << 6) | (p[2] & 0x3f);
+      if (wc < 0x800 || (wc >= 0xd800 && wc <= 0xdfff))
+	return false;
+      *inptrp = p + 3;
+    }
+  else if (wc >= 0xf0 && wc <= 0xf4)
+    {
+      if (avail < 4 || (p[1] & 0xc0) != 0x80 || (p[2] & 0xc0) != 0x80
+	  || (p[3] & 0xc0) != 0x80)
+	return false;
+      wc = (((wc & 0x07) << 18) | ((p[1] & 0x3f) << 12)
+	    | ((p[2] & 0x3f) << 6) | (p[3] & 0x3f));
+      if (wc < 0x10000 || wc > 0x10ffff)
+	return false;
+      *inptrp = p + 4;
+    }
+  else
+    return false;
+
+  *wcp = wc;
+  return true;
+}
+
+/* Encode WC, which is at least 0x80, at *OUTPTRP.  Return false if it
+   does not fit before OUTEND, or is not one of the characters handled
+   here.  */
+static __always_inline bool
+utf8_encode (uint32_t wc, unsigned char **outptrp, const unsigned char *outend)
+{
+  unsigned char *p = *outptrp;
+  size_t avail = outend - p;
+
+  if (wc < 0x800)
+    {
+      if (avail < 2)
+	return false;
+      p[0] = 0xc0 | (wc >> 6);
+      p[1] = 0x80 | (wc & 0x3f);
+      *outptrp = p + 2;
+    }
+  else if (wc < 0x10000)
+    {
+      if (avail < 3 || (wc >= 0xd800 && wc <= 0xdfff))
+	return false;
+      p[0] = 0xe0 | (wc >> 12);
+      p[1] = 0x80 | ((wc >> 6) & 0x3f);
+      p[2] = 0x80 | (wc & 0x3f);
+      *outptrp = p + 3;
+    }
+  else if (wc <= 0x10ffff)
+    {
+      if (avail < 4)
+	return false;
+      p[0] = 0xf0 | (wc >> 18);
+      p[1] = 0x80 | ((wc >> 12) & 0x3f);
+      p[2] = 0x80 | ((wc >> 6) & 0x3f);
+      p[3] = 0x80 | (wc & 0x3f);
+      *outptrp = p + 4;
+    }
+  else
+    return false;
+
+  return true;
+}
+
+void
+BULK_UTF8_INTERNAL (const unsigned char **inptrp, const unsigned char *inend,
+		    unsigned char **outptrp, const unsigned char *outend)
+{
+  const unsigned char *inptr = *inptrp;
+  unsigned char *outptr = *outptrp;
+
+  while (1)
+    {
+      while (inend - inptr >= ASCII_BLOCK
+	     && outend - outptr >= 4 * ASCII_BLOCK)
+	{
+	  size_t n = ascii_to_internal (inptr, outptr);
+	  inptr += n;
+	  outptr += 4 * n;
+	  if (n < ASCII_BLOCK)
+	    break;
+	}
+
+      /* Convert the characters one at a time up to the first ASCII one
+	 after a non-ASCII one, where the next block may start.  */
+      bool non_ascii = false;
+      while (1)
+	{
+	  if (inptr == inend || outend - outptr < sizeof (uint32_t))
+	    goto out;
+	  uint32_t wc = *inptr;
+	  if (wc < 0x80)
+	    {
+	      if (non_ascii)
+		break;
+	      ++inptr;
+	    }
+	  else if (utf8_decode (&inptr, inend, &wc))
+	    non_ascii = true;
+	  else
+	    goto out;
+	  *((uint32_t *) outptr) = wc;
+	  outptr += sizeof (uint32_t);
+	}
+    }
+
+ out:
+
+  *inptrp = inptr;
+  *outptrp = outptr;
+}
+
+void
+BULK_INTERNAL_UTF8 (const unsigned char **inptrp, const unsigned char *inend,
+		    unsigned char **outptrp, const unsigned char *outend)
+{
+  const unsigned char *inptr = *inptrp;
+  unsigned char *outptr = *outptrp;
+
+  while (1)
+    {
+      while (inend - inptr >= 4 * ASCII_BLOCK
+	     && outend - outptr >= ASCII_BLOCK)
+	{
+	  size_t n = internal_to_ascii (inptr, outptr);
+	  inptr += 4 * n;
+	  outptr += n;
+	  if (n < ASCII_BLOCK)
+	    break;
+	}
+
+      bool non_ascii = false;
+      while (1)
+	{
+	  if (inend - inptr < sizeof (uint32_t) || outptr == outend)
+	    goto out;
+	  uint32_t wc = *((const uint32_t *) inptr);
+	  if (wc < 0x80)
+	    {
+	      if (non_ascii)
+		break;
+	      *outptr++ = wc;
+	    }
+	  else if (utf8_encode (wc, &outptr, outend))
+	    non_ascii = true;
+	  else
+	    goto out;
+	  inptr += sizeof (uint32_t);
+	}
+    }
+
+ out:
+
+  *inptrp = inptr;
+  *outptrp = outptr;
+}
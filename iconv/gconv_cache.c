@@ -28,8 +28,7 @@
 #include <gconv_int.h>
 #include <iconvconfig.h>
 #include <not-cancel.h>
-
-#include "../intl/hash-string.h"
+#include <search.h>
 
 static void *gconv_cache;
 static size_t cache_size;
@@ -155,7 +154,7 @@ find_module_idx (const char *str, size_t *idxp)
   hashtab = (struct hash_entry *) ((char *) gconv_cache
 				   + header->hash_offset);
 
-  hval = __hash_string (str);
+  hval = __strhash (str, 0);
   idx = hval % header->hash_size;
   hval2 = 1 + hval % (header->hash_size - 2);
 
@@ -295,6 +295,24 @@ __BUILTIN_TRANSFORM (__gconv_transform_internal_utf16);
 __BUILTIN_TRANSFORM (__gconv_transform_utf16_internal);
 # undef __BUITLIN_TRANSFORM
 
+/* Convert the longest prefix of the UTF-8 input at *INPTRP which consists
+   of complete and well-formed characters up to 0x10ffff, other than
+   surrogates, to INTERNAL, as far as the output buffer allows.  Update
+   *INPTRP and *OUTPTRP.  The character at which the conversion stops is
+   left to the full rules of the conversion loop.  */
+extern void __gconv_bulk_utf8_internal (const unsigned char **inptrp,
+					const unsigned char *inend,
+					unsigned char **outptrp,
+					const unsigned char *outend)
+     attribute_hidden;
+
+/* Likewise for the conversion from INTERNAL to UTF-8.  */
+extern void __gconv_bulk_internal_utf8 (const unsigned char **inptrp,
+					const unsigned char *inend,
+					unsigned char **outptrp,
+					const unsigned char *outend)
+     attribute_hidden;
+
 /* Specialized conversion function for a single byte to INTERNAL, recognizing
    only ASCII characters.  */
 extern wint_t __gconv_btwoc_ascii (struct __gconv_step *step, unsigned char c);
@@ -884,6 +884,8 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
 #define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
 #define MAX_NEEDED_OUTPUT	MAX_NEEDED_TO
 #define LOOPFCT			FROM_LOOP
+#define BULK_BODY \
+  __gconv_bulk_internal_utf8 (&inptr, inend, &outptr, outend);
 #define BODY \
   {									      \
     uint32_t wc = *((const uint32_t *) inptr);				      \
@@ -947,6 +949,8 @@ ucs4le_internal_loop_single (struct __gconv_step *step,
 #define MAX_NEEDED_INPUT	MAX_NEEDED_FROM
 #define MIN_NEEDED_OUTPUT	MIN_NEEDED_TO
 #define LOOPFCT			FROM_LOOP
+#define BULK_BODY \
+  __gconv_bulk_utf8_internal (&inptr, inend, &outptr, outend);
 #define BODY \
   {									      \
     /* Next input byte.  */						      \
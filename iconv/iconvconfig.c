@@ -43,10 +43,6 @@
 #define PACKAGE _libc_intl_domainname
 
 
-/* The hashing function we use.  */
-#include "../intl/hash-string.h"
-
-
 /* Types used.  */
 struct module
 {
@@ -765,7 +761,7 @@ new_name (const char *str, struct Strent *strent)
   newp->name = str;
   newp->strent = strent;
   newp->module_idx = -1;
-  newp->hashval = __hash_string (str);
+  newp->hashval = strhash (str, 0);
 
   ++nnames;
 
@@ -59,7 +59,7 @@ struct extra_entry
 };
 
 
-#define GCONVCACHE_MAGIC	0x20010324
+#define GCONVCACHE_MAGIC	0x20211019
 
 
 #define GCONV_MODULES_CACHE	GCONV_DIR "/gconv-modules.cache"
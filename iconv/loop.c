@@ -44,6 +44,11 @@
 
      ONEBYTE_BODY	body of the specialized conversion function for a
 			single byte from the current character set to INTERNAL.
+
+     BULK_BODY		optional code run before BODY in the main loop.  It
+			may convert any number of complete characters which
+			need no error handling and no state, advancing INPTR
+			and OUTPTR, without passing INEND and OUTEND.
 */
 
 #include <assert.h>
@@ -307,6 +312,12 @@ FCTNAME (LOOPFCT) (struct __gconv_step *step,
 
   while (inptr != inend)
     {
+#ifdef BULK_BODY
+      BULK_BODY
+      if (inptr == inend)
+	break;
+#endif
+
       /* `if' cases for MIN_NEEDED_OUTPUT ==/!= 1 is made to help the
 	 compiler generating better code.  They will be optimized away
 	 since MIN_NEEDED_OUTPUT is always a constant.  */
@@ -529,6 +540,7 @@ gconv_btowc (struct __gconv_step *step, unsigned char c)
 #undef UPDATE_PARAMS
 #undef REINIT_PARAMS
 #undef ONEBYTE_BODY
+#undef BULK_BODY
 #undef UNPACK_BYTES
 #undef CLEAR_STATE
 #undef LOOP_NEED_STATE
@@ -0,0 +1,243 @@
+/* Test the conversions between UTF-8 and WCHAR_T on mixed text.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The conversions convert runs of ASCII and of well-formed characters
+   in bulk, and leave everything else to the character-at-a-time loop.
+   Check them on runs of ASCII of all lengths mixed with longer
+   characters, at all alignments and with output buffers of all sizes,
+   and check that invalid input is reported at the right place.  */
+
+#include <errno.h>
+#include <iconv.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <support/check.h>
+
+#define NCHARS 2048
+
+static wchar_t chars[NCHARS];
+static unsigned char utf8[4 * NCHARS];
+static size_t utf8_len;
+
+/* Encode WC, which is at most 0x1fffff, at P.  Return the length.  */
+static size_t
+encode (uint32_t wc, unsigned char *p)
+{
+  if (wc < 0x80)
+    {
+      p[0] = wc;
+      return 1;
+    }
+  if (wc < 0x800)
+    {
+      p[0] = 0xc0 | (wc >> 6);
+      p[1] = 0x80 | (wc & 0x3f);
+      return 2;
+    }
+  if (wc < 0x10000)
+    {
+      p[0] = 0xe0 | (wc >> 12);
+      p[1] = 0x80 | ((wc >> 6) & 0x3f);
+      p[2] = 0x80 | (wc & 0x3f);
+      return 3;
+    }
+  p[0] = 0xf0 | (wc >> 18);
+  p[1] = 0x80 | ((wc >> 12) & 0x3f);
+  p[2] = 0x80 | ((wc >> 6) & 0x3f);
+  p[3] = 0x80 | (wc & 0x3f);
+  return 4;
+}
+
+/* Fill CHARS with runs of ASCII separated by up to three longer
+   characters, and UTF8 with their encoding.  Characters beyond
+   0x10ffff are included; they are not converted in bulk.  */
+static void
+random_text (void)
+{
+  size_t i = 0;
+  while (i < NCHARS)
+    {
+      size_t run = rand () % 150;
+      for (; run > 0 && i < NCHARS; run--)
+	chars[i++] = 1 + rand () % 0x7f;
+      for (size_t n = 1 + rand () % 3; n > 0 && i < NCHARS; n--)
+	{
+	  uint32_t wc;
+	  switch (rand () % 8)
+	    {
+	    case 0:
+	    case 1:
+	    case 2:
+	      wc = 0x80 + rand () % 0x780;
+	      break;
+	    case 3:
+	    case 4:
+	      wc = 0x800 + rand () % 0xd000;
+	      break;
+	    case 5:
+	      wc = 0xe000 + rand () % 0x2000;
+	      break;
+	    case 6:
+	      wc = 0x10000 + rand () % 0x100000;
+	      break;
+	    default:
+	      wc = 0x110000 + rand () % 0xf0000;
+	      break;
+	    }
+	  chars[i++] = wc;
+	}
+    }
+
+  utf8_len = 0;
+  for (i = 0; i < NCHARS; i++)
+    utf8_len += encode (chars[i], utf8 + utf8_len);
+}
+
+/* Convert INLEN bytes at IN with CD to OUT, with at most CHUNK bytes
+   of output per call.  Return the length of the output.  */
+static size_t
+convert (iconv_t cd, const void *in, size_t inlen, void *out, size_t outlen,
+	 size_t chunk)
+{
+  char *inptr = (char *) in;
+  char *outptr = out;
+  char *outend = outptr + outlen;
+  while (inlen > 0)
+    {
+      size_t avail = outend - outptr < chunk ? outend - outptr : chunk;
+      size_t before = avail;
+      if (iconv (cd, &inptr, &inlen, &outptr, &avail) == (size_t) -1)
+	{
+	  TEST_COMPARE (errno, E2BIG);
+	  TEST_VERIFY_EXIT (avail != before);
+	}
+    }
+  return outptr - (char *) out;
+}
+
+static unsigned char inbuf[4 * NCHARS + 64];
+static unsigned char outbuf[4 * NCHARS + 64];
+
+static void
+check_valid (iconv_t from_utf8, iconv_t to_utf8, size_t chunk)
+{
+  size_t align = rand () % 16;
+  memcpy (inbuf + align, utf8, utf8_len);
+  wchar_t *wout = (wchar_t *) outbuf + align % 4;
+  TEST_COMPARE (convert (from_utf8, inbuf + align, utf8_len, wout,
+			 sizeof (chars), chunk * sizeof (wchar_t)),
+		sizeof (chars));
+  TEST_VERIFY (memcmp (wout, chars, sizeof (chars)) == 0);
+
+  wchar_t *win = (wchar_t *) inbuf + align % 4;
+  memcpy (win, chars, sizeof (chars));
+  TEST_COMPARE (convert (to_utf8, win, sizeof (chars), outbuf + align,
+			 utf8_len, chunk),
+		utf8_len);
+  TEST_VERIFY (memcmp (outbuf + align, utf8, utf8_len) == 0);
+}
+
+static const char *const invalid_utf8[] =
+  {
+    "\x80", "\xbf", "\xff", "\xc0\x80", "\xc1\xbf", "\xe0\x80\x80",
+    "\xed\xa0\x80", "\xed\xbf\xbf", "\xf0\x80\x80\x80", "\xe2\x82" "A",
+    "\xc3" "A", "\xf0\x9f\x98" "A"
+  };
+
+static const wchar_t invalid_wchar[] = { 0xd800, 0xdfff, 0x80000000 };
+
+static void
+check_invalid (iconv_t from_utf8, iconv_t to_utf8)
+{
+  /* Replace a character with an invalid sequence.  */
+  size_t pos = rand () % NCHARS;
+  size_t off = 0;
+  for (size_t i = 0; i < pos; i++)
+    off += encode (chars[i], inbuf + off);
+  const char *bad = invalid_utf8[rand () % (sizeof (invalid_utf8)
+					    / sizeof (invalid_utf8[0]))];
+  memcpy (inbuf + off, bad, strlen (bad));
+  size_t inlen = off + strlen (bad);
+  for (size_t i = pos + 1; i < NCHARS; i++)
+    inlen += encode (chars[i], inbuf + inlen);
+
+  char *inptr = (char *) inbuf;
+  char *outptr = (char *) outbuf;
+  size_t outlen = sizeof (outbuf);
+  TEST_VERIFY (iconv (from_utf8, &inptr, &inlen, &outptr, &outlen)
+	       == (size_t) -1);
+  TEST_COMPARE (errno, EILSEQ);
+  TEST_COMPARE (inptr - (char *) inbuf, off);
+  TEST_COMPARE (outptr - (char *) outbuf, pos * sizeof (wchar_t));
+  TEST_VERIFY (memcmp (outbuf, chars, pos * sizeof (wchar_t)) == 0);
+
+  /* A sequence cut off at the end of the input is incomplete.  */
+  inptr = (char *) inbuf;
+  inlen = off + 2;
+  memcpy (inbuf + off, "\xe2\x82", 2);
+  outptr = (char *) outbuf;
+  outlen = sizeof (outbuf);
+  TEST_VERIFY (iconv (from_utf8, &inptr, &inlen, &outptr, &outlen)
+	       == (size_t) -1);
+  TEST_COMPARE (errno, EINVAL);
+  TEST_COMPARE (inptr - (char *) inbuf, off);
+  iconv (from_utf8, NULL, NULL, NULL, NULL);
+
+  wchar_t *win = (wchar_t *) inbuf;
+  memcpy (win, chars, sizeof (chars));
+  win[pos] = invalid_wchar[rand () % (sizeof (invalid_wchar)
+				      / sizeof (invalid_wchar[0]))];
+  inptr = (char *) win;
+  inlen = sizeof (chars);
+  outptr = (char *) outbuf;
+  outlen = sizeof (outbuf);
+  TEST_VERIFY (iconv (to_utf8, &inptr, &inlen, &outptr, &outlen)
+	       == (size_t) -1);
+  TEST_COMPARE (errno, EILSEQ);
+  TEST_COMPARE (inptr - (char *) win, pos * sizeof (wchar_t));
+  TEST_COMPARE (outptr - (char *) outbuf, off);
+  TEST_VERIFY (memcmp (outbuf, utf8, off) == 0);
+}
+
+static int
+do_test (void)
+{
+  iconv_t from_utf8 = iconv_open ("WCHAR_T", "UTF-8");
+  TEST_VERIFY_EXIT (from_utf8 != (iconv_t) -1);
+  iconv_t to_utf8 = iconv_open ("UTF-8", "WCHAR_T");
+  TEST_VERIFY_EXIT (to_utf8 != (iconv_t) -1);
+
+  srand (1);
+  for (int iter = 0; iter < 100; iter++)
+    {
+      random_text ();
+      check_valid (from_utf8, to_utf8, 4 * NCHARS);
+      check_valid (from_utf8, to_utf8, 4 + rand () % 300);
+      check_valid (from_utf8, to_utf8, 4 + rand () % 8);
+      for (int i = 0; i < 10; i++)
+	check_invalid (from_utf8, to_utf8);
+    }
+
+  TEST_VERIFY_EXIT (iconv_close (from_utf8) == 0);
+  TEST_VERIFY_EXIT (iconv_close (to_utf8) == 0);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -69,6 +69,9 @@ struct r_scope_elem
   struct link_map **r_list;
   /* Number of entries in the scope.  */
   unsigned int r_nlist;
+  /* Combined symbol index of the objects in the scope, or NULL.  Only
+     used for the global scope of a namespace.  See dl-lookup.c.  */
+  struct r_scope_index *r_index;
 };
 
 
@@ -208,6 +211,10 @@ struct link_map
 				       freed, ie. not allocated with
 				       the dummy malloc in ld.so.  */
     unsigned int l_ld_readonly:1; /* Nonzero if dynamic section is readonly.  */
+    unsigned int l_visited:1;   /* Used internally for map dependency
+				   graph traversal.  */
+    unsigned int l_map_used:1;  /* These two bits are used during traversal */
+    unsigned int l_map_done:1;  /* of maps in _dl_close_worker. */
 
     /* NODELETE status of the map.  Only valid for maps of type
        lt_loaded.  Lazy binding sets l_nodelete_active directly,
@@ -344,6 +351,19 @@ struct link_map
     size_t l_relro_size;
 
     unsigned long long int l_serial;
+
+    /* Counters collected for LD_DEBUG=profile, indexed by enum
+       dl_profile_phase: the time in hp-timing units and the number of
+       page faults while mapping, relocating and initializing the
+       object, the number of symbol lookups done for it, and the number
+       of files which could not be opened while searching for it.  */
+    struct
+    {
+      uint64_t time[3];
+      unsigned long int faults[3];
+      unsigned long int lookups;
+      unsigned long int failed_probes;
+    } l_profile;
   };
 
 #include <dl-relocate-ld.h>
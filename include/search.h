@@ -9,6 +9,10 @@ libc_hidden_proto (__hdestroy_r)
 extern __typeof (hsearch_r) __hsearch_r;
 libc_hidden_proto (__hsearch_r)
 libc_hidden_proto (lfind)
+extern __typeof (memhash) __memhash;
+libc_hidden_proto (__memhash)
+extern __typeof (strhash) __strhash;
+libc_hidden_proto (__strhash)
 
 /* Now define the internal interfaces.  */
 extern void __hdestroy (void);
@@ -145,18 +145,10 @@ __hsearch_r (ENTRY item, ACTION action, ENTRY **retval,
 	     struct hsearch_data *htab)
 {
   unsigned int hval;
-  unsigned int count;
-  unsigned int len = strlen (item.key);
   unsigned int idx;
 
-  /* Compute an value for the given string. Perhaps use a better method. */
-  hval = len;
-  count = len;
-  while (count-- > 0)
-    {
-      hval <<= 4;
-      hval += item.key[count];
-    }
+  /* Compute an value for the given string.  */
+  hval = __strhash (item.key, 0);
   if (hval == 0)
     ++hval;
 
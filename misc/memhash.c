@@ -0,0 +1,173 @@
+/* Fast non-cryptographic hash of byte strings.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <endian.h>
+#include <search.h>
+#include <stdint.h>
+#include <string.h>
+
+/* The hash is built on the multiply-and-fold step of the wyhash
+   family: two 64-bit words are multiplied into a 128-bit product, and
+   its two halves are combined with XOR.  Keys of up to 16 bytes are
+   read as two possibly overlapping words without a loop.  Longer keys
+   are consumed 16 bytes at a time, or 48 bytes at a time in three
+   independent lanes, which keeps several multiplications in flight.
+   The final 16 bytes are always read from the end of the key.
+
+   For short keys this is faster than vector code on current
+   processors, because the whole key fits into two registers.  The
+   words are read in little-endian byte order, so the hash values are
+   the same on all architectures, and they do not change between
+   releases.  */
+
+static const uint64_t secret[4] =
+  {
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL,
+    0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+  };
+
+/* Replace *A and *B with the low and high halves of *A * *B.  */
+static inline void
+mum (uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+  unsigned __int128 r = (unsigned __int128) *a * *b;
+  *a = (uint64_t) r;
+  *b = (uint64_t) (r >> 64);
+#else
+  uint64_t ha = *a >> 32, hb = *b >> 32;
+  uint64_t la = (uint32_t) *a, lb = (uint32_t) *b;
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32);
+  uint64_t c = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+/* Return the XOR of the high and low halves of A * B.  */
+static inline uint64_t
+mix (uint64_t a, uint64_t b)
+{
+  mum (&a, &b);
+  return a ^ b;
+}
+
+static inline uint64_t
+read64 (const unsigned char *p)
+{
+  uint64_t v;
+  memcpy (&v, p, sizeof (v));
+  return le64toh (v);
+}
+
+static inline uint64_t
+read32 (const unsigned char *p)
+{
+  uint32_t v;
+  memcpy (&v, p, sizeof (v));
+  return le32toh (v);
+}
+
+static inline uint64_t
+hash (const unsigned char *p, size_t len, uint64_t seed)
+{
+  uint64_t a, b;
+
+  seed ^= mix (seed ^ secret[0], secret[1]);
+  if (__glibc_likely (len <= 16))
+    {
+      if (len >= 4)
+	{
+	  /* Two words from the start and two from the end, which
+	     overlap if LEN is less than 16.  */
+	  size_t mid = (len >> 3) << 2;
+	  a = (read32 (p) << 32) | read32 (p + mid);
+	  b = (read32 (p + len - 4) << 32) | read32 (p + len - 4 - mid);
+	}
+      else if (len > 0)
+	{
+	  a = ((uint64_t) p[0] << 16) | ((uint64_t) p[len >> 1] << 8)
+	      | p[len - 1];
+	  b = 0;
+	}
+      else
+	a = b = 0;
+    }
+  else
+    {
+      size_t i = len;
+      if (__glibc_unlikely (i > 48))
+	{
+	  uint64_t seed1 = seed, seed2 = seed;
+	  do
+	    {
+	      seed = mix (read64 (p) ^ secret[1], read64 (p + 8) ^ seed);
+	      seed1 = mix (read64 (p + 16) ^ secret[2],
+			   read64 (p + 24) ^ seed1);
+	      seed2 = mix (read64 (p + 32) ^ secret[3],
+			   read64 (p + 40) ^ seed2);
+	      p += 48;
+	      i -= 48;
+	    }
+	  while (i > 48);
+	  seed ^= seed1 ^ seed2;
+	}
+      while (i > 16)
+	{
+	  seed = mix (read64 (p) ^ secret[1], read64 (p + 8) ^ seed);
+	  p += 16;
+	  i -= 16;
+	}
+      a = read64 (p + i - 16);
+      b = read64 (p + i - 8);
+    }
+
+  a ^= secret[1];
+  b ^= seed;
+  mum (&a, &b);
+  return mix (a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+uint64_t
+__memhash (const void *key, size_t len, uint64_t seed)
+{
+  return hash (key, len, seed);
+}
+libc_hidden_def (__memhash)
+weak_alias (__memhash, memhash)
+
+uint64_t
+__strhash (const char *s, uint64_t seed)
+{
+  return hash ((const unsigned char *) s, strlen (s), seed);
+}
+libc_hidden_def (__strhash)
+weak_alias (__strhash, strhash)
+
+void
+memhash_batch (const void *const *keys, const size_t *lens, size_t count,
+	       uint64_t seed, uint64_t *hashes)
+{
+  /* The hashes of different keys are independent, so the processor
+     overlaps the multiplications of consecutive iterations.  */
+  for (size_t i = 0; i < count; ++i)
+    hashes[i] = hash (keys[i], lens[i], seed);
+}
@@ -23,6 +23,9 @@
 
 #define __need_size_t
 #include <stddef.h>
+#ifdef __USE_GNU
+# include <bits/types.h>
+#endif
 
 __BEGIN_DECLS
 
@@ -107,6 +110,23 @@ extern int hsearch_r (ENTRY __item, ACTION __action, ENTRY **__retval,
 		      struct hsearch_data *__htab) __THROW;
 extern int hcreate_r (size_t __nel, struct hsearch_data *__htab) __THROW;
 extern void hdestroy_r (struct hsearch_data *__htab) __THROW;
+
+/* Return a 64-bit hash of the N bytes at KEY.  Different values of SEED
+   select unrelated hash functions.  The result does not depend on the
+   architecture.  */
+extern __uint64_t memhash (const void *__key, size_t __n, __uint64_t __seed)
+     __THROW __attribute_pure__;
+
+/* Like memhash, but hash the bytes of the string S without the
+   terminating NUL byte.  */
+extern __uint64_t strhash (const char *__s, __uint64_t __seed)
+     __THROW __attribute_pure__ __nonnull ((1));
+
+/* Store in HASHES[I] the result of memhash (KEYS[I], LENS[I], SEED) for
+   each I less than COUNT.  */
+extern void memhash_batch (const void *const *__keys, const size_t *__lens,
+			   size_t __count, __uint64_t __seed,
+			   __uint64_t *__hashes) __THROW;
 #endif
 
 
@@ -0,0 +1,144 @@
+/* Test memhash, strhash and memhash_batch.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <array_length.h>
+#include <search.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+
+#define MAXLEN 256
+
+static unsigned char buf[MAXLEN + 16];
+
+/* The hash values do not depend on the architecture, so these are the
+   same everywhere.  BUF[I] is I * 7 + 3.  */
+static const struct
+{
+  size_t len;
+  uint64_t seed0;
+  uint64_t seed42;
+} known[] =
+  {
+    { 0, 0x0409638ee2bde459ULL, 0x72014e4eed7eeb7dULL },
+    { 1, 0xac4c24d5552ac9edULL, 0xa5b9af181df5975eULL },
+    { 2, 0xebe89e81a69e242eULL, 0x8dacbb6c2e2c645aULL },
+    { 3, 0x5f537215ae3e82f9ULL, 0xafc5059e14a4355bULL },
+    { 4, 0x6cbf4a473d35cedeULL, 0xfe66a8a1376dbbceULL },
+    { 7, 0xbe8ceb8e0ae54f1aULL, 0xea73f81abd4f9efcULL },
+    { 8, 0xdd7753dcc1e7d7a2ULL, 0x8f5b34b4147bc3e5ULL },
+    { 9, 0x1446304174856561ULL, 0x6ee2df29f141bf75ULL },
+    { 15, 0x2f88fdb9da44ad2bULL, 0xe532305359d1594cULL },
+    { 16, 0x853aa766ce2f8c64ULL, 0x3913176d5b65b508ULL },
+    { 17, 0x8c406b9bd1cbf3ffULL, 0x0837648bf8741625ULL },
+    { 31, 0x200d69bc726b4992ULL, 0xbf56e57e839c16ffULL },
+    { 32, 0x73d5bf9042fec682ULL, 0x22a61d2e049f2fbcULL },
+    { 33, 0x25cd17aea5279511ULL, 0xfc09c13831094a22ULL },
+    { 47, 0x62645a794bd2263fULL, 0x09ce86a615f305a2ULL },
+    { 48, 0x446d9fb23a188f73ULL, 0xaaf342cef6c865daULL },
+    { 49, 0x271253a8708703e1ULL, 0xf5b639be9dee1040ULL },
+    { 96, 0x8461f4e504f284fbULL, 0x8dd445425329793fULL },
+    { 97, 0xde2063f25fd5deacULL, 0xc47e59cf9e6434d3ULL },
+    { 200, 0x252464e8bd50954cULL, 0xd9309431c9b81b0bULL },
+  };
+
+static int
+compare_hashes (const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *) a;
+  uint64_t y = *(const uint64_t *) b;
+  return x < y ? -1 : x > y;
+}
+
+static int
+do_test (void)
+{
+  for (size_t i = 0; i < MAXLEN; ++i)
+    buf[i] = i * 7 + 3;
+
+  for (size_t i = 0; i < array_length (known); ++i)
+    {
+      TEST_COMPARE (memhash (buf, known[i].len, 0), known[i].seed0);
+      TEST_COMPARE (memhash (buf, known[i].len, 42), known[i].seed42);
+    }
+
+  /* The result must not depend on the alignment of the key.  */
+  unsigned char copy[MAXLEN + 16];
+  for (size_t len = 0; len <= MAXLEN; ++len)
+    {
+      uint64_t h = memhash (buf, len, 0);
+      for (size_t align = 1; align < 16; ++align)
+	{
+	  memcpy (copy + align, buf, len);
+	  TEST_COMPARE (memhash (copy + align, len, 0), h);
+	}
+      TEST_VERIFY (memhash (buf, len, 1) != h);
+    }
+
+  /* strhash hashes the bytes before the NUL byte.  */
+  char str[MAXLEN + 1];
+  for (size_t len = 0; len < MAXLEN; ++len)
+    {
+      memset (str, 'a' + len % 26, len);
+      str[len] = '\0';
+      TEST_COMPARE (strhash (str, 0), memhash (str, len, 0));
+      TEST_COMPARE (strhash (str, 7), memhash (str, len, 7));
+    }
+
+  /* memhash_batch gives the same results as individual calls.  */
+  const void *keys[MAXLEN + 1];
+  size_t lens[MAXLEN + 1];
+  uint64_t hashes[MAXLEN + 1];
+  for (size_t i = 0; i <= MAXLEN; ++i)
+    {
+      keys[i] = buf + i % 16;
+      lens[i] = MAXLEN - i;
+    }
+  memhash_batch (keys, lens, MAXLEN + 1, 3, hashes);
+  for (size_t i = 0; i <= MAXLEN; ++i)
+    TEST_COMPARE (hashes[i], memhash (keys[i], lens[i], 3));
+
+  /* Flipping any single bit of the key changes the hash, and no two
+     of the resulting keys collide.  Check short keys, a key handled by
+     the 16-byte loop and one handled by the 48-byte loop.  */
+  static const size_t flip_lens[] = { 1, 5, 16, 40, 100 };
+  for (size_t l = 0; l < array_length (flip_lens); ++l)
+    {
+      size_t len = flip_lens[l];
+      size_t nhashes = len * 8 + 1;
+      uint64_t *all = calloc (nhashes, sizeof (uint64_t));
+      TEST_VERIFY_EXIT (all != NULL);
+      memcpy (copy, buf, len);
+      all[0] = memhash (copy, len, 0);
+      for (size_t bit = 0; bit < len * 8; ++bit)
+	{
+	  copy[bit / 8] ^= 1 << (bit % 8);
+	  all[bit + 1] = memhash (copy, len, 0);
+	  copy[bit / 8] ^= 1 << (bit % 8);
+	}
+      qsort (all, nhashes, sizeof (uint64_t), compare_hashes);
+      for (size_t i = 1; i < nhashes; ++i)
+	TEST_VERIFY (all[i] != all[i - 1]);
+      free (all);
+    }
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -308,6 +308,13 @@ struct pthread
   /* Two-level array for the thread-specific data.  */
   struct pthread_key_data *specific[PTHREAD_KEY_1STLEVEL_SIZE];
 
+  /* Keys which may have been set to a non-NULL value.  Bit I of
+     SPECIFIC_KEYS[N] stands for key N * PTHREAD_KEY_2NDLEVEL_SIZE + I,
+     and bit N of SPECIFIC_BLOCKS is set if SPECIFIC_KEYS[N] may be
+     nonzero.  This way the thread exit does not have to scan all keys.  */
+  uint32_t specific_keys[PTHREAD_KEY_1STLEVEL_SIZE];
+  uint32_t specific_blocks;
+
   /* Flag which is set when specific data is set.  */
   bool specific_used;
 
@@ -17,6 +17,13 @@
 
 #include <pthreadP.h>
 
+/* The key bitmaps in struct pthread use one bit per key of a
+   second-level block and one bit per block.  */
+_Static_assert (PTHREAD_KEY_2NDLEVEL_SIZE <= 32,
+                "second-level TSD block fits into a bitmap word");
+_Static_assert (PTHREAD_KEY_1STLEVEL_SIZE <= 32,
+                "TSD blocks fit into a bitmap word");
+
 /* Deallocate POSIX thread-local-storage.  */
 void
 __nptl_deallocate_tsd (void)
@@ -33,49 +40,57 @@ __nptl_deallocate_tsd (void)
       round = 0;
       do
         {
-          size_t idx;
-
           /* So far no new nonzero data entry.  */
           THREAD_SETMEM (self, specific_used, false);
 
-          for (cnt = idx = 0; cnt < PTHREAD_KEY_1STLEVEL_SIZE; ++cnt)
+          /* Only visit the keys which pthread_setspecific recorded.
+             Take the bits out of the bitmaps before calling any
+             destructor so that keys set again by a destructor are
+             visited in the next round.  */
+          uint32_t blocks = THREAD_GETMEM (self, specific_blocks);
+          THREAD_SETMEM (self, specific_blocks, 0);
+
+          while (blocks != 0)
             {
-              struct pthread_key_data *level2;
+              cnt = __builtin_ctz (blocks);
+              blocks &= blocks - 1;
 
-              level2 = THREAD_GETMEM_NC (self, specific, cnt);
+              uint32_t keys = THREAD_GETMEM_NC (self, specific_keys, cnt);
+              THREAD_SETMEM_NC (self, specific_keys, cnt, 0);
 
-              if (level2 != NULL)
+              /* The second-level array was allocated before the bit was
+                 set, and is only freed below.  */
+              struct pthread_key_data *level2
+                = THREAD_GETMEM_NC (self, specific, cnt);
+
+              while (keys != 0)
                 {
-                  size_t inner;
+                  size_t inner = __builtin_ctz (keys);
+                  size_t idx = cnt * PTHREAD_KEY_2NDLEVEL_SIZE + inner;
+                  keys &= keys - 1;
+
+                  void *data = level2[inner].data;
 
-                  for (inner = 0; inner < PTHREAD_KEY_2NDLEVEL_SIZE;
-                       ++inner, ++idx)
+                  if (data != NULL)
                     {
-                      void *data = level2[inner].data;
-
-                      if (data != NULL)
-                        {
-                          /* Always clear the data.  */
-                          level2[inner].data = NULL;
-
-                          /* Make sure the data corresponds to a valid
-                             key.  This test fails if the key was
-                             deallocated and also if it was
-                             re-allocated.  It is the user's
-                             responsibility to free the memory in this
-                             case.  */
-                          if (level2[inner].seq
-                              == __pthread_keys[idx].seq
-                              /* It is not necessary to register a destructor
-                                 function.  */
-                              && __pthread_keys[idx].destr != NULL)
-                            /* Call the user-provided destructor.  */
-                            __pthread_keys[idx].destr (data);
-                        }
+                      /* Always clear the data.  */
+                      level2[inner].data = NULL;
+
+                      /* Make sure the data corresponds to a valid
+                         key.  This test fails if the key was
+                         deallocated and also if it was
+                         re-allocated.  It is the user's
+                         responsibility to free the memory in this
+                         case.  */
+                      if (level2[inner].seq
+                          == __pthread_keys[idx].seq
+                          /* It is not necessary to register a destructor
+                             function.  */
+                          && __pthread_keys[idx].destr != NULL)
+                        /* Call the user-provided destructor.  */
+                        __pthread_keys[idx].destr (data);
                     }
                 }
-              else
-                idx += PTHREAD_KEY_1STLEVEL_SIZE;
             }
 
           if (THREAD_GETMEM (self, specific_used) == 0)
@@ -88,6 +103,9 @@ __nptl_deallocate_tsd (void)
       /* Just clear the memory of the first block for reuse.  */
       memset (&THREAD_SELF->specific_1stblock, '\0',
               sizeof (self->specific_1stblock));
+      memset (&THREAD_SELF->specific_keys, '\0',
+              sizeof (self->specific_keys));
+      THREAD_SETMEM (self, specific_blocks, 0);
 
     just_free:
       /* Free the memory for the other blocks.  */
@@ -87,10 +87,11 @@
      pthread_barrier_destroy will of course wait for the signal handler thread
      to confirm that it left the barrier.
 
-   TODO We should add spinning with back-off.  Once we do that, we could also
-   try to avoid the futex_wake syscall when a round is detected as finished.
-   If we do not spin, it is quite likely that at least some other threads will
-   have called futex_wait already.  */
+   Before blocking, threads spin for a bounded number of rounds if this is
+   enabled (see max_wait_spin_count).
+   TODO With spinning, we could also try to avoid the futex_wake syscall
+   when a round is detected as finished, but that requires tracking
+   whether any thread has called futex_wait.  */
 int
 ___pthread_barrier_wait (pthread_barrier_t *barrier)
 {
@@ -177,6 +178,15 @@ ___pthread_barrier_wait (pthread_barrier_t *barrier)
 	}
     }
 
+  /* Spin for a bounded number of rounds first; if the round finishes
+     shortly after, this saves the futex_wait call.  See the fence below
+     for the MO.  */
+  for (int spin = max_wait_spin_count (); i > cr && spin > 0; spin--)
+    {
+      atomic_spin_nop ();
+      cr = atomic_load_relaxed (&bar->current_round);
+    }
+
   /* Wait until the current round is more recent than the round we are in.  */
   while (i > cr)
     {
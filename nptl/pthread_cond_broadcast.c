@@ -33,7 +33,17 @@
    section: (1) signal all waiters in G1, (2) close G1 so that it can become
    the new G2 and make G2 the new G1, and (3) signal all waiters in the new
    G1.  We don't need to do all these steps if there are no waiters in G1
-   and/or G2.  See __pthread_cond_signal for further details.  */
+   and/or G2.  See __pthread_cond_signal for further details.
+
+   Note that we do not requeue waiters onto the mutex's futex (as the old
+   condvar implementation did with FUTEX_CMP_REQUEUE).  A waiter blocked on
+   __g_signals holds a reference on its group, which it only drops after it
+   has returned from futex_wait.  If it was requeued onto the mutex, it would
+   keep that reference until the mutex is released; a subsequent signal or
+   broadcast issued while holding the mutex would then block forever in
+   __condvar_quiesce_and_switch_g1 waiting for the reference to go away.
+   Instead, we avoid the futex_wake syscalls entirely if no waiter is
+   actually blocked on the futex.  */
 int
 ___pthread_cond_broadcast (pthread_cond_t *cond)
 {
@@ -60,11 +70,12 @@ ___pthread_cond_broadcast (pthread_cond_t *cond)
 				cond->__data.__g_size[g1] << 1);
       cond->__data.__g_size[g1] = 0;
 
-      /* We need to wake G1 waiters before we quiesce G1 below.  */
-      /* TODO Only set it if there are indeed futex waiters.  We could
-	 also try to move this out of the critical section in cases when
-	 G2 is empty (and we don't need to quiesce).  */
-      futex_wake (cond->__data.__g_signals + g1, INT_MAX, private);
+      /* We need to wake G1 waiters before we quiesce G1 below, but only
+	 if there are indeed futex waiters.  */
+      /* TODO We could also try to move this out of the critical section in
+	 cases when G2 is empty (and we don't need to quiesce).  */
+      if (__condvar_have_futex_waiters (cond, g1))
+	futex_wake (cond->__data.__g_signals + g1, INT_MAX, private);
     }
 
   /* G1 is complete.  Step (2) is next unless there are no waiters in G2, in
@@ -75,8 +86,8 @@ ___pthread_cond_broadcast (pthread_cond_t *cond)
       atomic_fetch_add_relaxed (cond->__data.__g_signals + g1,
 				cond->__data.__g_size[g1] << 1);
       cond->__data.__g_size[g1] = 0;
-      /* TODO Only set it if there are indeed futex waiters.  */
-      do_futex_wake = true;
+      /* Only wake if there are indeed futex waiters.  */
+      do_futex_wake = __condvar_have_futex_waiters (cond, g1);
     }
 
   __condvar_release_lock (cond, private);
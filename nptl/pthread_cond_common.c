@@ -329,6 +329,25 @@ __condvar_get_private (int flags)
     return FUTEX_SHARED;
 }
 
+/* Returns true if there might be waiters blocked (or about to block) on the
+   futex of group G, in which case the caller has to issue a futex_wake after
+   having added signals to __g_signals[G].  Waiters acquire a group reference
+   before they block on __g_signals; the signaler adds signals before it
+   checks __g_refs.  This is a Dekker-style synchronization: the seq_cst
+   fence here pairs with the one in __pthread_cond_wait_common, so that
+   either we see the waiter's group reference or the waiter's futex_wait will
+   see our signals and not block.  The count in __g_refs is conservative
+   because it includes waiters that are just about to notice that their
+   group is closed, but we never miss a waiter that is blocked.  Skipping the
+   futex_wake saves a syscall in the common case of signaling a condvar
+   whose waiters are all still spinning or have already been woken.  */
+static bool __attribute__ ((unused))
+__condvar_have_futex_waiters (pthread_cond_t *cond, unsigned int g)
+{
+  atomic_thread_fence_seq_cst ();
+  return (atomic_load_relaxed (cond->__data.__g_refs + g) >> 1) != 0;
+}
+
 /* This closes G1 (whose index is in G1INDEX), waits for all futex waiters to
    leave G1, converts G1 into a fresh G2, and then switches group roles so that
    the former G2 becomes the new G1 ending at the current __wseq value when we
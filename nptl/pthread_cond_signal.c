@@ -83,8 +83,8 @@ ___pthread_cond_signal (pthread_cond_t *cond)
 	 read-modify-write and thus extend that store's release sequence.  */
       atomic_fetch_add_relaxed (cond->__data.__g_signals + g1, 2);
       cond->__data.__g_size[g1]--;
-      /* TODO Only set it if there are indeed futex waiters.  */
-      do_futex_wake = true;
+      /* Only wake if there are indeed futex waiters.  */
+      do_futex_wake = __condvar_have_futex_waiters (cond, g1);
     }
 
   __condvar_release_lock (cond, private);
@@ -379,7 +379,7 @@ static __always_inline int
 __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
     clockid_t clockid, const struct __timespec64 *abstime)
 {
-  const int maxspin = 0;
+  const int maxspin = max_wait_spin_count ();
   int err;
   int result = 0;
 
@@ -453,7 +453,7 @@ __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
 	      if (seq < (__condvar_load_g1_start_relaxed (cond) >> 1))
 		goto done;
 
-	      /* TODO Back off.  */
+	      atomic_spin_nop ();
 
 	      /* Reload signals.  See above for MO.  */
 	      signals = atomic_load_acquire (cond->__data.__g_signals + g);
@@ -480,8 +480,13 @@ __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
 	     Note that the group reference acquisition will not mask the
 	     release MO when decrementing the reference count because we use
 	     an atomic read-modify-write operation and thus extend the release
-	     sequence.  */
+	     sequence.
+	     The seq_cst fence pairs with the one in
+	     __condvar_have_futex_waiters: signalers that do not observe our
+	     group reference skip the futex_wake, so they must have added
+	     their signals before our futex_wait checks __g_signals.  */
 	  atomic_fetch_add_acquire (cond->__data.__g_refs + g, 2);
+	  atomic_thread_fence_seq_cst ();
 	  if (((atomic_load_acquire (cond->__data.__g_signals + g) & 1) != 0)
 	      || (seq < (__condvar_load_g1_start_relaxed (cond) >> 1)))
 	    {
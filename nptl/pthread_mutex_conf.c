@@ -30,6 +30,9 @@ struct mutex_config __mutex_aconf =
   /* The maximum number of times a thread should spin on the lock before
   calling into kernel to block.  */
   .spin_count = DEFAULT_ADAPTIVE_COUNT,
+  /* The maximum number of times a thread should spin in sem_wait,
+  pthread_barrier_wait and pthread_cond_wait before blocking.  */
+  .wait_spin_count = 0,
 };
 libc_hidden_data_def (__mutex_aconf)
 
@@ -39,6 +42,12 @@ TUNABLE_CALLBACK (set_mutex_spin_count) (tunable_val_t *valp)
   __mutex_aconf.spin_count = (int32_t) (valp)->numval;
 }
 
+static void
+TUNABLE_CALLBACK (set_wait_spin_count) (tunable_val_t *valp)
+{
+  __mutex_aconf.wait_spin_count = (int32_t) (valp)->numval;
+}
+
 static void
 TUNABLE_CALLBACK (set_stack_cache_size) (tunable_val_t *valp)
 {
@@ -50,6 +59,8 @@ __pthread_tunables_init (void)
 {
   TUNABLE_GET (mutex_spin_count, int32_t,
                TUNABLE_CALLBACK (set_mutex_spin_count));
+  TUNABLE_GET (wait_spin_count, int32_t,
+               TUNABLE_CALLBACK (set_wait_spin_count));
   TUNABLE_GET (stack_cache_size, size_t,
                TUNABLE_CALLBACK (set_stack_cache_size));
 }
@@ -0,0 +1,684 @@
+/* Work-stealing thread pool.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <pthread.h>
+#include <pthreadP.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include <sys/sysinfo.h>
+#include <atomic.h>
+#include <ldsodefs.h>
+#include <libc-pointer-arith.h>
+#include <futex-internal.h>
+#include <lowlevellock.h>
+
+/* Overview:
+
+   Each worker owns a fixed-size Chase-Lev deque of tasks (see "Correct and
+   Efficient Work-Stealing for Weak Memory Models", Lê et al., PPoPP 2013).
+   Tasks submitted from a worker of the same pool are pushed onto the bottom
+   of that worker's deque, and the worker takes them from the bottom again
+   (LIFO, which keeps the data the task works on in the cache).  Idle
+   workers steal from the top of other workers' deques.  Tasks submitted by
+   threads that are not workers of the pool, and tasks that do not fit into
+   a full deque, are put on a lock-protected FIFO injection queue that all
+   workers take from.
+
+   A worker that does not find any work spins for up to max_adaptive_count
+   rounds (see the glibc.pthread.mutex_spin_count tunable) and then parks on
+   the WAKE_SEQ futex.  Parking and submission use Dekker-style
+   synchronization: the worker increments NIDLE, reads WAKE_SEQ and then
+   checks all queues once more; the submitter enqueues its task and then
+   checks NIDLE.  Both sides issue a seq_cst fence in between, so either the
+   worker sees the new task or the submitter sees the idle worker and
+   increments WAKE_SEQ before waking it, which makes the worker's futex_wait
+   fail or return.
+
+   PENDING counts submitted tasks that have not completed yet.
+   pthread_pool_wait_np blocks on it using the same synchronization scheme
+   with NWAITERS.
+
+   Workers are regular threads created with pthread_create, so thread-local
+   storage destructors and TSD destructors run for them when the pool is
+   destroyed.  If a task terminates its worker by calling pthread_exit, a
+   cleanup handler accounts for the task, and the remaining workers continue
+   to process the pool's tasks (including those left in the deque of the
+   exited worker, which stay available for stealing).  The same applies if
+   a task acts on a cancellation request for its worker.
+
+   pthread_pool_wait_np is a cancellation point, and so is
+   pthread_pool_destroy_np while it waits for the tasks.  Once it starts
+   terminating the workers, cancellation is disabled until the pool has
+   been freed, so that a canceled pthread_pool_destroy_np leaves the pool
+   intact.  */
+
+/* Number of tasks in each worker's deque.  Must be a power of two.  */
+#define POOL_DEQUE_SIZE 256
+
+/* Used to keep frequently written fields on separate cache lines.  */
+#define POOL_CACHE_LINE 64
+
+struct pool_task
+{
+  void (*routine) (void *);
+  void *arg;
+  struct pool_task *next;
+};
+
+struct pool_worker
+{
+  /* Stealers increment TOP; the owner increments and decrements BOTTOM.
+     Both are only ever compared by their difference, so that they can
+     wrap around.  */
+  unsigned int top;
+  char pad1[POOL_CACHE_LINE - sizeof (unsigned int)];
+  unsigned int bottom;
+  char pad2[POOL_CACHE_LINE - sizeof (unsigned int)];
+  struct pool_task *tasks[POOL_DEQUE_SIZE];
+
+  struct pthread_pool *pool;
+  pthread_t thread;
+  /* Seed for choosing steal victims.  */
+  unsigned int seed;
+  /* The task this worker is currently running, or NULL.  */
+  struct pool_task *current;
+  /* Set once the worker has been started successfully.  */
+  bool started;
+};
+
+struct pthread_pool
+{
+  /* Injection queue.  */
+  int lock;
+  struct pool_task *head;
+  struct pool_task *tail;
+  unsigned int ninjected;
+  char pad1[POOL_CACHE_LINE];
+
+  unsigned int pending;
+  unsigned int nwaiters;
+  char pad2[POOL_CACHE_LINE];
+
+  unsigned int wake_seq;
+  unsigned int nidle;
+  unsigned int shutdown;
+
+  unsigned int nworkers;
+  struct pool_worker workers[];
+};
+
+/* The worker the calling thread is, if any.  */
+static __thread struct pool_worker *pool_self attribute_tls_model_ie;
+
+
+/* Pushes TASK onto the bottom of the deque of W.  Only called by the owner
+   of W.  Returns false if the deque is full.  */
+static bool
+deque_push (struct pool_worker *w, struct pool_task *task)
+{
+  unsigned int b = atomic_load_relaxed (&w->bottom);
+  /* Acquire MO so that the reads of stealers that incremented TOP happen
+     before we overwrite the slot.  */
+  unsigned int t = atomic_load_acquire (&w->top);
+  if (b - t >= POOL_DEQUE_SIZE)
+    return false;
+  atomic_store_relaxed (&w->tasks[b % POOL_DEQUE_SIZE], task);
+  /* Release MO so that stealers see the task.  */
+  atomic_store_release (&w->bottom, b + 1);
+  return true;
+}
+
+/* Takes the task from the bottom of the deque of W, or returns NULL if it is
+   empty.  Only called by the owner of W.  */
+static struct pool_task *
+deque_take (struct pool_worker *w)
+{
+  unsigned int b = atomic_load_relaxed (&w->bottom) - 1;
+  atomic_store_relaxed (&w->bottom, b);
+  atomic_thread_fence_seq_cst ();
+  unsigned int t = atomic_load_relaxed (&w->top);
+  if ((int) (b - t) < 0)
+    {
+      /* Empty.  */
+      atomic_store_relaxed (&w->bottom, b + 1);
+      return NULL;
+    }
+
+  struct pool_task *task
+    = atomic_load_relaxed (&w->tasks[b % POOL_DEQUE_SIZE]);
+  if (b == t)
+    {
+      /* This is the last task, so we race with stealers.  If the CAS fails
+	 spuriously, the task stays in the deque and will be taken later.  */
+      if (!atomic_compare_exchange_weak_acquire (&w->top, &t, t + 1))
+	task = NULL;
+      atomic_store_relaxed (&w->bottom, b + 1);
+    }
+  return task;
+}
+
+/* Steals the task from the top of the deque of W, or returns NULL if it is
+   empty or we lost a race with another thread.  */
+static struct pool_task *
+deque_steal (struct pool_worker *w)
+{
+  unsigned int t = atomic_load_acquire (&w->top);
+  atomic_thread_fence_seq_cst ();
+  unsigned int b = atomic_load_acquire (&w->bottom);
+  if ((int) (b - t) <= 0)
+    return NULL;
+  struct pool_task *task
+    = atomic_load_relaxed (&w->tasks[t % POOL_DEQUE_SIZE]);
+  /* Release MO so that our read of the slot happens before the owner
+     overwrites it (see deque_push).  */
+  if (!atomic_compare_exchange_weak_release (&w->top, &t, t + 1))
+    return NULL;
+  return task;
+}
+
+static bool
+deque_empty (struct pool_worker *w)
+{
+  return (int) (atomic_load_acquire (&w->bottom)
+		- atomic_load_acquire (&w->top)) <= 0;
+}
+
+static void
+inject_push (struct pthread_pool *pool, struct pool_task *task)
+{
+  task->next = NULL;
+  lll_lock (pool->lock, LLL_PRIVATE);
+  if (pool->tail == NULL)
+    pool->head = task;
+  else
+    pool->tail->next = task;
+  pool->tail = task;
+  atomic_store_relaxed (&pool->ninjected, pool->ninjected + 1);
+  lll_unlock (pool->lock, LLL_PRIVATE);
+}
+
+static struct pool_task *
+inject_pop (struct pthread_pool *pool)
+{
+  /* Avoid taking the lock if the queue is empty.  */
+  if (atomic_load_relaxed (&pool->ninjected) == 0)
+    return NULL;
+
+  lll_lock (pool->lock, LLL_PRIVATE);
+  struct pool_task *task = pool->head;
+  if (task != NULL)
+    {
+      pool->head = task->next;
+      if (pool->head == NULL)
+	pool->tail = NULL;
+      atomic_store_relaxed (&pool->ninjected, pool->ninjected - 1);
+    }
+  lll_unlock (pool->lock, LLL_PRIVATE);
+  return task;
+}
+
+/* Returns true if there is a task in any of the queues of POOL.  */
+static bool
+pool_has_work (struct pthread_pool *pool)
+{
+  if (atomic_load_relaxed (&pool->ninjected) != 0)
+    return true;
+  for (unsigned int i = 0; i < pool->nworkers; i++)
+    if (!deque_empty (&pool->workers[i]))
+      return true;
+  return false;
+}
+
+/* Wakes up one parked worker if there is one.  Called after a task has been
+   made available.  */
+static void
+pool_wake_one (struct pthread_pool *pool)
+{
+  atomic_thread_fence_seq_cst ();
+  if (atomic_load_relaxed (&pool->nidle) != 0)
+    {
+      atomic_fetch_add_release (&pool->wake_seq, 1);
+      futex_wake (&pool->wake_seq, 1, FUTEX_PRIVATE);
+    }
+}
+
+/* Marks one task as completed and wakes pthread_pool_wait_np callers if it
+   was the last one.  */
+static void
+pool_task_done (struct pthread_pool *pool)
+{
+  /* Release MO so that the effects of the task happen before the return of
+     pthread_pool_wait_np.  */
+  if (atomic_fetch_add_release (&pool->pending, -1) == 1)
+    {
+      atomic_thread_fence_seq_cst ();
+      if (atomic_load_relaxed (&pool->nwaiters) != 0)
+	futex_wake (&pool->pending, INT_MAX, FUTEX_PRIVATE);
+    }
+}
+
+/* Tries to steal a task from the other workers, starting at a random
+   victim.  */
+static struct pool_task *
+pool_steal (struct pthread_pool *pool, struct pool_worker *self)
+{
+  unsigned int n = pool->nworkers;
+  self->seed = self->seed * 1103515245 + 12345;
+  unsigned int start = (self->seed >> 16) % n;
+  for (unsigned int i = 0; i < n; i++)
+    {
+      struct pool_worker *victim = &pool->workers[(start + i) % n];
+      if (victim == self)
+	continue;
+      struct pool_task *task = deque_steal (victim);
+      if (task != NULL)
+	return task;
+    }
+  return NULL;
+}
+
+static struct pool_task *
+pool_find_task (struct pthread_pool *pool, struct pool_worker *self)
+{
+  struct pool_task *task = deque_take (self);
+  if (task == NULL)
+    task = inject_pop (pool);
+  if (task == NULL)
+    task = pool_steal (pool, self);
+  return task;
+}
+
+/* Called if a task terminates its worker thread.  */
+static void
+pool_worker_cleanup (void *arg)
+{
+  struct pool_worker *self = arg;
+  if (self->current != NULL)
+    {
+      free (self->current);
+      self->current = NULL;
+      pool_task_done (self->pool);
+    }
+  pool_self = NULL;
+}
+
+static void
+pool_worker_loop (struct pthread_pool *pool, struct pool_worker *self)
+{
+  while (1)
+    {
+      struct pool_task *task = pool_find_task (pool, self);
+
+      /* Spin for a while before parking, in case new work arrives soon.  */
+      for (int spin = max_adaptive_count ();
+	   task == NULL && spin > 0
+	     && atomic_load_relaxed (&pool->shutdown) == 0;
+	   spin--)
+	{
+	  atomic_spin_nop ();
+	  if (pool_has_work (pool))
+	    task = pool_find_task (pool, self);
+	}
+
+      if (task != NULL)
+	{
+	  self->current = task;
+	  task->routine (task->arg);
+	  self->current = NULL;
+	  free (task);
+	  pool_task_done (pool);
+	  continue;
+	}
+
+      /* Acquire MO so that we see all tasks submitted before the pool is
+	 shut down (see pthread_pool_destroy_np).  */
+      if (atomic_load_acquire (&pool->shutdown) != 0)
+	return;
+
+      /* Park.  See the overview above.  */
+      atomic_fetch_add_relaxed (&pool->nidle, 1);
+      unsigned int seq = atomic_load_acquire (&pool->wake_seq);
+      atomic_thread_fence_seq_cst ();
+      if (!pool_has_work (pool) && atomic_load_relaxed (&pool->shutdown) == 0)
+	futex_wait_simple (&pool->wake_seq, seq, FUTEX_PRIVATE);
+      atomic_fetch_add_relaxed (&pool->nidle, -1);
+    }
+}
+
+static void *
+pool_worker_start (void *arg)
+{
+  struct pool_worker *self = arg;
+  pool_self = self;
+
+  /* Tasks may call pthread_exit or throw exceptions (see pthread_once).  */
+  pthread_cleanup_combined_push (pool_worker_cleanup, self);
+  pool_worker_loop (self->pool, self);
+  pthread_cleanup_combined_pop (0);
+
+  pool_self = NULL;
+  return NULL;
+}
+
+/* Stops and joins all started workers of POOL and frees it.  */
+static void
+pool_shutdown (struct pthread_pool *pool)
+{
+  /* Joining a worker is a cancellation point.  */
+  int state;
+  __pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, &state);
+
+  atomic_store_release (&pool->shutdown, 1);
+  atomic_fetch_add_release (&pool->wake_seq, 1);
+  futex_wake (&pool->wake_seq, INT_MAX, FUTEX_PRIVATE);
+
+  for (unsigned int i = 0; i < pool->nworkers; i++)
+    if (pool->workers[i].started)
+      __pthread_join (pool->workers[i].thread, NULL);
+
+  free (pool);
+  __pthread_setcancelstate (state, NULL);
+}
+
+/* Returns the number of CPUs in the affinity set of ATTR, or 0 if ATTR does
+   not have an affinity set.  */
+static unsigned int
+pool_attr_cpu_count (const struct pthread_attr *attr)
+{
+  if (attr == NULL || attr->extension == NULL
+      || attr->extension->cpuset == NULL)
+    return 0;
+
+  unsigned int count = 0;
+  for (size_t cpu = 0; cpu < attr->extension->cpusetsize * 8; cpu++)
+    if (CPU_ISSET_S (cpu, attr->extension->cpusetsize,
+		     attr->extension->cpuset))
+      count++;
+  return count;
+}
+
+/* Restricts the worker with index IDX to a single CPU of the affinity set in
+   SOURCE, or does nothing if SOURCE does not restrict the workers to more
+   than one CPU.  The CPUs are assigned round-robin.  */
+static int
+pool_worker_affinity (pthread_attr_t *attr, const struct pthread_attr *source,
+		      unsigned int idx)
+{
+  unsigned int count = pool_attr_cpu_count (source);
+  if (count <= 1)
+    return 0;
+
+  const cpu_set_t *cpuset = source->extension->cpuset;
+  size_t cpusetsize = source->extension->cpusetsize;
+  unsigned int nth = idx % count;
+  for (size_t cpu = 0; cpu < cpusetsize * 8; cpu++)
+    if (CPU_ISSET_S (cpu, cpusetsize, cpuset) && nth-- == 0)
+      {
+	size_t singlesize = CPU_ALLOC_SIZE (cpu + 1);
+	cpu_set_t *single = malloc (singlesize);
+	if (single == NULL)
+	  return ENOMEM;
+	CPU_ZERO_S (singlesize, single);
+	CPU_SET_S (cpu, singlesize, single);
+	int ret = __pthread_attr_setaffinity_np (attr, singlesize, single);
+	free (single);
+	return ret;
+      }
+  return 0;
+}
+
+int
+pthread_pool_create_np (pthread_pool_t **poolp, unsigned int nthreads,
+			const pthread_attr_t *attr)
+{
+  const struct pthread_attr *iattr = (const struct pthread_attr *) attr;
+
+  /* All workers would run on the same stack.  */
+  if (iattr != NULL && (iattr->flags & ATTR_FLAG_STACKADDR) != 0)
+    return EINVAL;
+
+  if (nthreads == 0)
+    {
+      nthreads = pool_attr_cpu_count (iattr);
+      if (nthreads == 0)
+	nthreads = __get_nprocs ();
+      if (nthreads == 0)
+	nthreads = 1;
+    }
+
+  size_t size;
+  if (__builtin_mul_overflow (nthreads, sizeof (struct pool_worker), &size)
+      || __builtin_add_overflow (size, sizeof (struct pthread_pool), &size))
+    return EINVAL;
+
+  struct pthread_pool *pool = calloc (1, size);
+  if (pool == NULL)
+    return ENOMEM;
+  pool->lock = LLL_LOCK_INITIALIZER;
+  pool->nworkers = nthreads;
+
+  int ret = 0;
+  for (unsigned int i = 0; i < nthreads && ret == 0; i++)
+    {
+      struct pool_worker *w = &pool->workers[i];
+      w->pool = pool;
+      w->seed = i;
+
+      pthread_attr_t wattr;
+      if (attr != NULL)
+	ret = __pthread_attr_copy (&wattr, attr);
+      else
+	ret = __pthread_attr_init (&wattr);
+      if (ret != 0)
+	break;
+      /* We need to join the workers.  */
+      ((struct pthread_attr *) &wattr)->flags &= ~ATTR_FLAG_DETACHSTATE;
+      ret = pool_worker_affinity (&wattr, iattr, i);
+      if (ret == 0)
+	ret = __pthread_create (&w->thread, &wattr, pool_worker_start, w);
+      __pthread_attr_destroy (&wattr);
+      if (ret == 0)
+	w->started = true;
+    }
+
+  if (ret != 0)
+    {
+      pool_shutdown (pool);
+      return ret;
+    }
+
+  *poolp = pool;
+  return 0;
+}
+
+static int
+pool_submit (struct pthread_pool *pool, void (*routine) (void *), void *arg)
+{
+  struct pool_task *task = malloc (sizeof (*task));
+  if (task == NULL)
+    return ENOMEM;
+  task->routine = routine;
+  task->arg = arg;
+
+  atomic_fetch_add_relaxed (&pool->pending, 1);
+
+  struct pool_worker *self = pool_self;
+  if (self == NULL || self->pool != pool || !deque_push (self, task))
+    inject_push (pool, task);
+
+  pool_wake_one (pool);
+  return 0;
+}
+
+int
+pthread_pool_submit_np (pthread_pool_t *pool, void (*routine) (void *),
+			void *arg)
+{
+  return pool_submit (pool, routine, arg);
+}
+
+/* Called if the thread is canceled in pthread_pool_wait_np.  */
+static void
+pool_wait_cleanup (void *arg)
+{
+  struct pthread_pool *pool = arg;
+  atomic_fetch_add_relaxed (&pool->nwaiters, -1);
+}
+
+int
+pthread_pool_wait_np (pthread_pool_t *pool)
+{
+  struct pool_worker *self = pool_self;
+  if (self != NULL && self->pool == pool)
+    /* We would wait for our own task to complete.  */
+    return EDEADLK;
+
+  unsigned int pending;
+  /* Acquire MO so that we synchronize with pool_task_done.  */
+  while ((pending = atomic_load_acquire (&pool->pending)) != 0)
+    {
+      atomic_fetch_add_relaxed (&pool->nwaiters, 1);
+      atomic_thread_fence_seq_cst ();
+      pthread_cleanup_push (pool_wait_cleanup, pool);
+      if (atomic_load_relaxed (&pool->pending) == pending)
+	__futex_abstimed_wait_cancelable64 (&pool->pending, pending, 0, NULL,
+					    FUTEX_PRIVATE);
+      pthread_cleanup_pop (1);
+    }
+  return 0;
+}
+
+int
+pthread_pool_destroy_np (pthread_pool_t *pool)
+{
+  int ret = pthread_pool_wait_np (pool);
+  if (ret != 0)
+    return ret;
+  pool_shutdown (pool);
+  return 0;
+}
+
+/* pthread_pool_memcpy_np splits the copy into chunks of at least this
+   size.  Each chunk is large enough for memcpy to use non-temporal
+   stores on current processors, and to amortize waking up a worker.  */
+#define POOL_MEMCPY_MIN_CHUNK (4 * 1024 * 1024)
+
+/* A copy shared between the caller of pthread_pool_memcpy_np and the
+   tasks it submits.  Threads claim chunks by incrementing NEXT, and
+   count the copied chunks in DONE, which the caller waits on.  The
+   caller and each task hold a reference; the last one frees the
+   structure, because tasks can start after the copy is complete.  */
+struct pool_memcpy
+{
+  char *dest;
+  const char *src;
+  size_t n;
+  size_t chunk;
+  unsigned int nchunks;
+  unsigned int next;
+  unsigned int done;
+  unsigned int refs;
+};
+
+/* Copies chunks of JOB until none is left.  */
+static void
+pool_memcpy_run (struct pool_memcpy *job)
+{
+  unsigned int i;
+  while ((i = atomic_fetch_add_relaxed (&job->next, 1)) < job->nchunks)
+    {
+      size_t off = i * job->chunk;
+      size_t len = MIN (job->chunk, job->n - off);
+      memcpy (job->dest + off, job->src + off, len);
+      /* Release MO so that the copy happens before the return of
+	 pthread_pool_memcpy_np.  */
+      if (atomic_fetch_add_release (&job->done, 1) == job->nchunks - 1)
+	futex_wake (&job->done, 1, FUTEX_PRIVATE);
+    }
+}
+
+static void
+pool_memcpy_unref (struct pool_memcpy *job)
+{
+  if (atomic_fetch_add_acq_rel (&job->refs, -1) == 1)
+    free (job);
+}
+
+static void
+pool_memcpy_task (void *arg)
+{
+  pool_memcpy_run (arg);
+  pool_memcpy_unref (arg);
+}
+
+void *
+pthread_pool_memcpy_np (pthread_pool_t *pool, void *dest, const void *src,
+			size_t n)
+{
+  /* Use as many chunks as there are threads, but split large copies
+     further so that the threads finish at about the same time even if
+     some of them start late.  */
+  unsigned int nthreads = pool->nworkers + 1;
+  size_t chunk = n / (2 * nthreads);
+  if (chunk < POOL_MEMCPY_MIN_CHUNK)
+    chunk = POOL_MEMCPY_MIN_CHUNK;
+  chunk = ALIGN_UP (chunk, GLRO(dl_pagesize));
+  size_t nchunks = n / chunk + (n % chunk != 0);
+  if (nchunks < 2 || nchunks > UINT_MAX)
+    return memcpy (dest, src, n);
+
+  struct pool_memcpy *job = malloc (sizeof (*job));
+  if (job == NULL)
+    return memcpy (dest, src, n);
+  job->dest = dest;
+  job->src = src;
+  job->n = n;
+  job->chunk = chunk;
+  job->nchunks = nchunks;
+  job->next = 0;
+  job->done = 0;
+
+  /* The calling thread copies chunks too, so one task fewer than
+     chunks suffices.  */
+  unsigned int ntasks = MIN (nchunks - 1, pool->nworkers);
+  job->refs = ntasks + 1;
+  for (unsigned int i = 0; i < ntasks; i++)
+    if (pool_submit (pool, pool_memcpy_task, job) != 0)
+      {
+	/* Copy the rest in this thread.  */
+	atomic_fetch_add_relaxed (&job->refs, -(ntasks - i));
+	break;
+      }
+
+  /* Workers which do not get to run before all chunks are claimed find
+     nothing left to do.  Since this thread takes part in the copy and
+     only waits for chunks which are being copied, it does not wait for
+     the workers if they are busy with other tasks, and it can be a
+     worker of POOL itself.  */
+  pool_memcpy_run (job);
+  unsigned int done;
+  /* Acquire MO so that we synchronize with pool_memcpy_run.  */
+  while ((done = atomic_load_acquire (&job->done)) != nchunks)
+    futex_wait_simple (&job->done, done, FUTEX_PRIVATE);
+
+  pool_memcpy_unref (job);
+  return dest;
+}
@@ -25,6 +25,7 @@
 #include <atomic.h>
 #include <futex-internal.h>
 #include <time.h>
+#include <elide.h>
 
 
 /* A reader--writer lock that fulfills the POSIX requirements (but operations
@@ -208,11 +209,31 @@
    POSIX allows but does not require rwlock acquisitions to be a cancellation
    point.  We do not support cancellation.
 
-   TODO We do not try to elide any read or write lock acquisitions currently.
-   While this would be possible, it is unclear whether HTM performance is
-   currently predictable enough and our runtime tuning is good enough at
-   deciding when to use elision so that enabling it would lead to consistently
-   better performance.  */
+   On x86, if lock elision is enabled (see the glibc.elision.enable tunable),
+   read and write lock acquisitions first try to elide the lock using a
+   hardware transaction, which only succeeds if the lock is free (i.e.,
+   __readers has no bit other than PTHREAD_RWLOCK_WRPHASE set).  An elided acquisition does not modify the lock, so a concurrent
+   real acquisition aborts the transaction.  Whether to try elision is
+   decided per lock: __rwelision is used as the adaptation count of the
+   lock, so that after an abort only this lock falls back to regular
+   acquisitions for a number of attempts (see the glibc.elision.skip_*
+   tunables), while other locks keep using elision.  Elided critical sections
+   do not set __cur_writer, so recursive acquisitions that would otherwise
+   fail with EDEADLK may succeed inside a transaction; this is allowed because
+   the behavior is undefined for such uses.  */
+
+
+/* Returns true if RWLOCK is neither acquired by readers nor by a writer.
+   A write phase without readers or WRLOCKED is the state a writer leaves
+   behind when it unlocks, so it is free too.  When used with ELIDE_LOCK,
+   this is evaluated inside the transaction so that __readers becomes
+   part of the transaction's read set.  */
+static __always_inline bool
+__pthread_rwlock_is_free (pthread_rwlock_t *rwlock)
+{
+  unsigned int r = atomic_load_relaxed (&rwlock->__data.__readers);
+  return (r & ~PTHREAD_RWLOCK_WRPHASE) == 0;
+}
 
 
 static int
@@ -299,6 +320,11 @@ __pthread_rwlock_rdlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
 			== THREAD_GETMEM (THREAD_SELF, tid)))
     return EDEADLK;
 
+  /* Try to elide the lock first; see above.  */
+  if (ELIDE_LOCK (rwlock->__data.__rwelision,
+		  __pthread_rwlock_is_free (rwlock)))
+    return 0;
+
   /* If we prefer writers, recursive rdlock is disallowed, we are in a read
      phase, and there are other readers present, we try to wait without
      extending the read phase.  We will be unblocked by either one of the
@@ -604,6 +630,11 @@ __pthread_rwlock_wrlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
 			== THREAD_GETMEM (THREAD_SELF, tid)))
     return EDEADLK;
 
+  /* Try to elide the lock first; see above.  */
+  if (ELIDE_LOCK (rwlock->__data.__rwelision,
+		  __pthread_rwlock_is_free (rwlock)))
+    return 0;
+
   /* First we try to acquire the role of primary writer by setting WRLOCKED;
      if it was set before, there already is a primary writer.  Acquire MO so
      that we synchronize with previous primary writers.
@@ -19,6 +19,7 @@
 #include "pthreadP.h"
 #include <atomic.h>
 #include <shlib-compat.h>
+#include "pthread_rwlock_common.c"
 
 /* See pthread_rwlock_common.c for an overview.  */
 int
@@ -34,6 +35,10 @@ ___pthread_rwlock_trywrlock (pthread_rwlock_t *rwlock)
      live-locks / starvation and must not fail spuriously (see there for
      further comments) -- and thus must loop until we get a definitive
      observation or state change.  */
+  if (ELIDE_TRYLOCK (rwlock->__data.__rwelision,
+		     __pthread_rwlock_is_free (rwlock), 1))
+    return 0;
+
   unsigned int r = atomic_load_relaxed (&rwlock->__data.__readers);
   bool prefer_writer =
       (rwlock->__data.__flags != PTHREAD_RWLOCK_PREFER_READER_NP);
@@ -30,6 +30,11 @@ ___pthread_rwlock_unlock (pthread_rwlock_t *rwlock)
 {
   LIBC_PROBE (rwlock_unlock, 1, rwlock);
 
+  /* An elided acquisition leaves the lock free, whereas a real one never
+     does.  Thus, if the lock is free, we must be in a transaction.  */
+  if (ELIDE_UNLOCK (__pthread_rwlock_is_free (rwlock)))
+    return 0;
+
   /* We distinguish between having acquired a read vs. a write lock by looking
      at the writer TID.  If it's equal to our TID, we must be the writer
      because nobody else can have stored this value.  Also, if we are a
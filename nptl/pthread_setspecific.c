@@ -40,6 +40,8 @@ ___pthread_setspecific (pthread_key_t key, const void *value)
 	/* Not valid.  */
 	return EINVAL;
 
+      idx1st = 0;
+      idx2nd = key;
       level2 = &self->specific_1stblock[key];
 
       /* Remember that we stored at least one set of data.  */
@@ -86,6 +88,15 @@ ___pthread_setspecific (pthread_key_t key, const void *value)
   level2->seq = seq;
   level2->data = (void *) value;
 
+  /* Record the key so that __nptl_deallocate_tsd only needs to look at
+     the keys which were actually used.  Resetting a key to NULL leaves
+     the bit set; the thread exit checks the data anyway.  */
+  if (value != NULL)
+    {
+      self->specific_keys[idx1st] |= 1U << idx2nd;
+      self->specific_blocks |= 1U << idx1st;
+    }
+
   return 0;
 }
 versioned_symbol (libc, ___pthread_setspecific, pthread_setspecific,
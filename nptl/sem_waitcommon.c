@@ -158,6 +158,45 @@ __new_sem_wait_fast (struct new_sem *sem, int definitive_result)
 #endif
 }
 
+/* Spin for a bounded number of rounds waiting for a token, before
+   registering as a waiter and blocking.  This avoids the futex round
+   trip if the token is posted shortly after.  The number of rounds is
+   adapted like for PTHREAD_MUTEX_ADAPTIVE_NP mutexes, with the estimate
+   kept in the otherwise unused pad field.  Returns 0 if a token was
+   grabbed.  */
+static int
+__new_sem_wait_spin (struct new_sem *sem)
+{
+  int max_cnt = max_wait_spin_count ();
+  if (max_cnt <= 0)
+    return -1;
+
+  /* A semaphore in shared memory may hold any value in pad, so clamp
+     the estimate before it is used.  */
+  int spins = atomic_load_relaxed (&sem->pad);
+  if (spins < 0)
+    spins = 0;
+  else if (spins > max_cnt)
+    spins = max_cnt;
+  max_cnt = adaptive_spin_limit (spins);
+
+  int cnt = 0;
+  int ret = -1;
+  while (cnt++ < max_cnt)
+    {
+      atomic_spin_nop ();
+      if (__new_sem_wait_fast (sem, 0) == 0)
+	{
+	  ret = 0;
+	  break;
+	}
+    }
+
+  /* The estimate is only a hint, so concurrent updates may be lost.  */
+  atomic_store_relaxed (&sem->pad, adaptive_spin_update (spins, cnt));
+  return ret;
+}
+
 /* Slow path that blocks.  */
 static int
 __attribute__ ((noinline))
@@ -166,6 +205,9 @@ __new_sem_wait_slow64 (struct new_sem *sem, clockid_t clockid,
 {
   int err = 0;
 
+  if (__new_sem_wait_spin (sem) == 0)
+    return 0;
+
 #if __HAVE_64B_ATOMICS
   /* Add a waiter.  Relaxed MO is sufficient because we can rely on the
      ordering provided by the RMW operations we use.  */
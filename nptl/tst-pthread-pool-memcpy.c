@@ -0,0 +1,104 @@
+/* Test pthread_pool_memcpy_np.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/support.h>
+
+#define MAXLEN (64 * 1024 * 1024 + 4096)
+
+static pthread_pool_t *pool;
+static unsigned char *src;
+static unsigned char *dest;
+
+static void
+check_copy (size_t dest_off, size_t src_off, size_t len)
+{
+  memset (dest, 0, len + dest_off + 1);
+  TEST_VERIFY (pthread_pool_memcpy_np (pool, dest + dest_off, src + src_off,
+				       len) == dest + dest_off);
+  for (size_t i = 0; i < dest_off; i++)
+    TEST_COMPARE (dest[i], 0);
+  TEST_VERIFY (memcmp (dest + dest_off, src + src_off, len) == 0);
+  TEST_COMPARE (dest[dest_off + len], 0);
+}
+
+static void
+check_all (void)
+{
+  check_copy (0, 0, 0);
+  check_copy (1, 3, 100);
+  check_copy (0, 0, 4 * 1024 * 1024);
+  check_copy (7, 0, 9 * 1024 * 1024 + 5);
+  check_copy (0, 13, 32 * 1024 * 1024);
+  check_copy (61, 3, 64 * 1024 * 1024 + 1);
+}
+
+static void
+copy_in_worker (void *arg)
+{
+  check_all ();
+}
+
+static sem_t block;
+
+static void
+block_worker (void *arg)
+{
+  sem_wait (&block);
+}
+
+static int
+do_test (void)
+{
+  src = xmalloc (MAXLEN);
+  dest = xmalloc (MAXLEN);
+  for (size_t i = 0; i < MAXLEN; i++)
+    src[i] = i * 23 + i / 4096;
+
+  static const unsigned int nthreads[] = { 1, 4 };
+  for (size_t i = 0; i < sizeof (nthreads) / sizeof (nthreads[0]); i++)
+    {
+      TEST_COMPARE (pthread_pool_create_np (&pool, nthreads[i], NULL), 0);
+      check_all ();
+
+      /* A task may copy with the pool it runs on.  */
+      TEST_COMPARE (pthread_pool_submit_np (pool, copy_in_worker, NULL), 0);
+      TEST_COMPARE (pthread_pool_wait_np (pool), 0);
+
+      /* The copy completes even if all workers are busy.  */
+      TEST_COMPARE (sem_init (&block, 0, 0), 0);
+      for (unsigned int j = 0; j < nthreads[i]; j++)
+	TEST_COMPARE (pthread_pool_submit_np (pool, block_worker, NULL), 0);
+      check_all ();
+      for (unsigned int j = 0; j < nthreads[i]; j++)
+	TEST_COMPARE (sem_post (&block), 0);
+
+      TEST_COMPARE (pthread_pool_destroy_np (pool), 0);
+      TEST_COMPARE (sem_destroy (&block), 0);
+    }
+
+  free (src);
+  free (dest);
+  return 0;
+}
+
+#include <support/test-driver.c>
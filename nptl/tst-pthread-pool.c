@@ -0,0 +1,179 @@
+/* Tests for the work-stealing thread pool.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+
+static pthread_pool_t *pool;
+static unsigned int counter;
+
+static void
+count (void *arg)
+{
+  __atomic_fetch_add (&counter, 1, __ATOMIC_RELAXED);
+}
+
+/* Submits two subtasks until DEPTH reaches zero, so that the tasks are
+   mostly pushed onto the workers' own deques and need to be stolen.  */
+static void
+spawn (void *arg)
+{
+  uintptr_t depth = (uintptr_t) arg;
+  __atomic_fetch_add (&counter, 1, __ATOMIC_RELAXED);
+  if (depth > 0)
+    {
+      TEST_COMPARE (pthread_pool_submit_np (pool, spawn,
+					    (void *) (depth - 1)), 0);
+      TEST_COMPARE (pthread_pool_submit_np (pool, spawn,
+					    (void *) (depth - 1)), 0);
+    }
+}
+
+static void
+wait_in_worker (void *arg)
+{
+  TEST_COMPARE (pthread_pool_wait_np (pool), EDEADLK);
+}
+
+static void
+exit_worker (void *arg)
+{
+  __atomic_fetch_add (&counter, 1, __ATOMIC_RELAXED);
+  pthread_exit (NULL);
+}
+
+static void
+cancel_worker (void *arg)
+{
+  __atomic_fetch_add (&counter, 1, __ATOMIC_RELAXED);
+  TEST_COMPARE (pthread_cancel (pthread_self ()), 0);
+  pthread_testcancel ();
+  FAIL_EXIT1 ("pthread_testcancel returned");
+}
+
+static sem_t release;
+
+static void
+block (void *arg)
+{
+  TEST_COMPARE (sem_wait (&release), 0);
+}
+
+static void *
+waiter (void *arg)
+{
+  pthread_pool_wait_np (pool);
+  FAIL_EXIT1 ("pthread_pool_wait_np was not canceled");
+}
+
+static void
+run_tests (unsigned int nthreads, const pthread_attr_t *attr)
+{
+  TEST_COMPARE (pthread_pool_create_np (&pool, nthreads, attr), 0);
+
+  counter = 0;
+  for (int i = 0; i < 10000; i++)
+    TEST_COMPARE (pthread_pool_submit_np (pool, count, NULL), 0);
+  TEST_COMPARE (pthread_pool_wait_np (pool), 0);
+  TEST_COMPARE (counter, 10000);
+
+  /* 2^13 - 1 tasks, more than fit into a single deque.  */
+  counter = 0;
+  TEST_COMPARE (pthread_pool_submit_np (pool, spawn, (void *) 12), 0);
+  TEST_COMPARE (pthread_pool_wait_np (pool), 0);
+  TEST_COMPARE (counter, (1 << 13) - 1);
+
+  TEST_COMPARE (pthread_pool_submit_np (pool, wait_in_worker, NULL), 0);
+  TEST_COMPARE (pthread_pool_wait_np (pool), 0);
+
+  /* A waiting pool must be reusable.  */
+  counter = 0;
+  for (int i = 0; i < 100; i++)
+    TEST_COMPARE (pthread_pool_submit_np (pool, count, NULL), 0);
+  TEST_COMPARE (pthread_pool_destroy_np (pool), 0);
+  TEST_COMPARE (counter, 100);
+}
+
+static int
+do_test (void)
+{
+  run_tests (1, NULL);
+  run_tests (4, NULL);
+  run_tests (0, NULL);
+
+  /* Bind the workers to the CPUs the process may run on.  */
+  cpu_set_t cpuset;
+  TEST_COMPARE (sched_getaffinity (0, sizeof (cpuset), &cpuset), 0);
+  pthread_attr_t attr;
+  xpthread_attr_init (&attr);
+  TEST_COMPARE (pthread_attr_setaffinity_np (&attr, sizeof (cpuset),
+					     &cpuset), 0);
+  xpthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+  run_tests (0, &attr);
+  run_tests (3, &attr);
+  xpthread_attr_destroy (&attr);
+
+  /* A task may terminate its worker; the other workers continue.  */
+  TEST_COMPARE (pthread_pool_create_np (&pool, 2, NULL), 0);
+  counter = 0;
+  TEST_COMPARE (pthread_pool_submit_np (pool, exit_worker, NULL), 0);
+  for (int i = 0; i < 100; i++)
+    TEST_COMPARE (pthread_pool_submit_np (pool, count, NULL), 0);
+  TEST_COMPARE (pthread_pool_destroy_np (pool), 0);
+  TEST_COMPARE (counter, 101);
+
+  /* Likewise if it acts on a cancellation request.  */
+  TEST_COMPARE (pthread_pool_create_np (&pool, 2, NULL), 0);
+  counter = 0;
+  TEST_COMPARE (pthread_pool_submit_np (pool, cancel_worker, NULL), 0);
+  for (int i = 0; i < 100; i++)
+    TEST_COMPARE (pthread_pool_submit_np (pool, count, NULL), 0);
+  TEST_COMPARE (pthread_pool_destroy_np (pool), 0);
+  TEST_COMPARE (counter, 101);
+
+  /* pthread_pool_wait_np is a cancellation point.  */
+  TEST_COMPARE (sem_init (&release, 0, 0), 0);
+  TEST_COMPARE (pthread_pool_create_np (&pool, 2, NULL), 0);
+  TEST_COMPARE (pthread_pool_submit_np (pool, block, NULL), 0);
+  pthread_t thr = xpthread_create (NULL, waiter, NULL);
+  TEST_COMPARE (pthread_cancel (thr), 0);
+  TEST_VERIFY (xpthread_join (thr) == PTHREAD_CANCELED);
+  TEST_COMPARE (sem_post (&release), 0);
+  TEST_COMPARE (pthread_pool_destroy_np (pool), 0);
+  TEST_COMPARE (sem_destroy (&release), 0);
+
+  /* The workers cannot share a stack.  */
+  xpthread_attr_init (&attr);
+  size_t stacksize = 1024 * 1024;
+  void *stack = xmalloc (stacksize);
+  TEST_COMPARE (pthread_attr_setstack (&attr, stack, stacksize), 0);
+  TEST_COMPARE (pthread_pool_create_np (&pool, 2, &attr), EINVAL);
+  xpthread_attr_destroy (&attr);
+  free (stack);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,147 @@
+/* Test sem_wait, pthread_barrier_wait and pthread_cond_wait with spinning.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The test is run with glibc.pthread.wait_spin_count set, so waiters
+   spin before blocking.  Check that handoffs through each primitive
+   are neither lost nor duplicated, whether the waiter gets the token
+   while spinning or after blocking, and that timeouts still work.  */
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <string.h>
+#include <time.h>
+#include <internaltypes.h>
+#include <support/check.h>
+#include <support/timespec.h>
+#include <support/xtime.h>
+#include <support/xthread.h>
+
+#define ROUNDS 20000
+#define NTHREADS 3
+
+static sem_t ping;
+static sem_t pong;
+
+static void *
+sem_thread (void *arg)
+{
+  for (int i = 0; i < ROUNDS; i++)
+    {
+      TEST_COMPARE (sem_wait (&ping), 0);
+      TEST_COMPARE (sem_post (&pong), 0);
+    }
+  return NULL;
+}
+
+static pthread_barrier_t barrier;
+static unsigned int arrived;
+
+static void *
+barrier_thread (void *arg)
+{
+  for (unsigned int i = 0; i < ROUNDS; i++)
+    {
+      __atomic_fetch_add (&arrived, 1, __ATOMIC_RELAXED);
+      xpthread_barrier_wait (&barrier);
+      /* All threads of this round have arrived, and none of the next.  */
+      TEST_COMPARE (__atomic_load_n (&arrived, __ATOMIC_RELAXED),
+		    (i + 1) * NTHREADS);
+      xpthread_barrier_wait (&barrier);
+    }
+  return NULL;
+}
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static int turn;
+
+static void *
+cond_thread (void *arg)
+{
+  int me = (int) (long int) arg;
+  for (int i = 0; i < ROUNDS; i++)
+    {
+      xpthread_mutex_lock (&mutex);
+      while (turn != me)
+	xpthread_cond_wait (&cond, &mutex);
+      turn = !me;
+      TEST_COMPARE (pthread_cond_broadcast (&cond), 0);
+      xpthread_mutex_unlock (&mutex);
+    }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  TEST_COMPARE (sem_init (&ping, 0, 0), 0);
+  TEST_COMPARE (sem_init (&pong, 0, 0), 0);
+  pthread_t thr = xpthread_create (NULL, sem_thread, NULL);
+  for (int i = 0; i < ROUNDS; i++)
+    {
+      TEST_COMPARE (sem_post (&ping), 0);
+      TEST_COMPARE (sem_wait (&pong), 0);
+    }
+  xpthread_join (thr);
+  int value;
+  TEST_COMPARE (sem_getvalue (&ping, &value), 0);
+  TEST_COMPARE (value, 0);
+  TEST_COMPARE (sem_getvalue (&pong, &value), 0);
+  TEST_COMPARE (value, 0);
+
+  /* Spinning does not delay or prevent the timeout.  */
+  struct timespec ts = timespec_add (xclock_now (CLOCK_REALTIME),
+				     make_timespec (0, 10000000));
+  TEST_COMPARE (sem_timedwait (&ping, &ts), -1);
+  TEST_COMPARE (errno, ETIMEDOUT);
+
+  /* The spin estimate of a semaphore in shared memory may hold any
+     value.  */
+  sem_t fresh;
+  memset (&fresh, 0xff, sizeof (fresh));
+  TEST_COMPARE (sem_init (&fresh, 0, 0), 0);
+  TEST_COMPARE (((struct new_sem *) &fresh)->pad, 0);
+  struct new_sem *isem = (struct new_sem *) &ping;
+  isem->pad = INT_MAX;
+  TEST_COMPARE (sem_timedwait (&ping, &ts), -1);
+  TEST_COMPARE (errno, ETIMEDOUT);
+  isem->pad = INT_MIN;
+  TEST_COMPARE (sem_timedwait (&ping, &ts), -1);
+  TEST_COMPARE (errno, ETIMEDOUT);
+
+  xpthread_barrier_init (&barrier, NULL, NTHREADS);
+  pthread_t thrs[NTHREADS];
+  for (int i = 0; i < NTHREADS; i++)
+    thrs[i] = xpthread_create (NULL, barrier_thread, NULL);
+  for (int i = 0; i < NTHREADS; i++)
+    xpthread_join (thrs[i]);
+  TEST_COMPARE (arrived, ROUNDS * NTHREADS);
+  xpthread_barrier_destroy (&barrier);
+
+  thrs[0] = xpthread_create (NULL, cond_thread, (void *) 0L);
+  thrs[1] = xpthread_create (NULL, cond_thread, (void *) 1L);
+  xpthread_join (thrs[0]);
+  xpthread_join (thrs[1]);
+  TEST_COMPARE (turn, 0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -301,7 +301,7 @@ struct hashentry
 
 
 /* Current persistent database version.  */
-#define DB_VERSION	2
+#define DB_VERSION	3
 
 /* Maximum time allowed between updates of the timestamp.  */
 #define MAPPING_TIMEOUT (5 * 60)
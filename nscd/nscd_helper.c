@@ -36,6 +36,7 @@
 #include <not-cancel.h>
 #include <kernel-features.h>
 #include <nss.h>
+#include <search.h>
 #include <struct___timespec64.h>
 
 #include "nscd-client.h"
@@ -450,7 +451,8 @@ struct datahead *
 __nscd_cache_search (request_type type, const char *key, size_t keylen,
 		     const struct mapped_database *mapped, size_t datalen)
 {
-  unsigned long int hash = __nss_hash (key, keylen) % mapped->head->module;
+  unsigned long int hash = (__memhash (key, keylen, 0)
+			    % mapped->head->module);
   size_t datasize = mapped->datasize;
 
   ref_t trail = mapped->head->array[hash];
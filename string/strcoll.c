@@ -21,6 +21,7 @@
 # define STRING_TYPE char
 # define STRCOLL strcoll
 # define STRCOLL_L __strcoll_l
+# define STRCMP strcmp
 # define USE_HIDDEN_DEF
 #endif
 
@@ -30,6 +31,11 @@
 int
 STRCOLL (const STRING_TYPE *s1, const STRING_TYPE *s2)
 {
+  /* Without collation rules, as in the C and POSIX locales, the order is
+     that of the character codes.  Compare directly instead of looking up
+     the locale again in STRCOLL_L.  */
+  if (_NL_CURRENT_WORD (LC_COLLATE, _NL_COLLATE_NRULES) == 0)
+    return STRCMP (s1, s2);
   return STRCOLL_L (s1, s2, _NL_CURRENT_LOCALE);
 }
 
@@ -32,6 +32,10 @@
 #define  CMP    2
 #define  LEN    3
 
+/* Words used to skip the common prefix.  */
+typedef unsigned long int word_t;
+#define  WORDSIZE sizeof (word_t)
+
 
 /* Compare S1 and S2 as strings holding indices/version numbers,
    returning less than, equal to or greater than zero if S1 is less than,
@@ -68,6 +72,43 @@ __strverscmp (const char *s1, const char *s2)
   if (p1 == p2)
     return 0;
 
+  /* Skip the common prefix a word at a time if both strings have the
+     same alignment; aligned loads cannot cross into an unmapped page.
+     The words are compared for equality and checked for a null byte,
+     and the state machine starts at the beginning of the first word
+     which fails either check.  */
+  if ((((uintptr_t) p1 ^ (uintptr_t) p2) % WORDSIZE) == 0)
+    {
+      while ((uintptr_t) p1 % WORDSIZE != 0 && *p1 == *p2 && *p1 != '\0')
+	{
+	  ++p1;
+	  ++p2;
+	}
+      if ((uintptr_t) p1 % WORDSIZE == 0)
+	{
+	  const word_t lsb = (word_t) -1 / 0xff;
+	  const word_t msb = lsb << 7;
+	  while (1)
+	    {
+	      word_t w1 = *(const word_t *) p1;
+	      word_t w2 = *(const word_t *) p2;
+	      if (w1 != w2 || ((w1 - lsb) & ~w1 & msb) != 0)
+		break;
+	      p1 += WORDSIZE;
+	      p2 += WORDSIZE;
+	    }
+	}
+
+      /* The state only depends on the digits before the current
+	 character, which are the same in both strings.  Back up to the
+	 first of them so that the state machine can start in S_N.  */
+      while (p1 != (const unsigned char *) s1 && isdigit (p1[-1]))
+	{
+	  --p1;
+	  --p2;
+	}
+    }
+
   unsigned char c1 = *p1++;
   unsigned char c2 = *p2++;
   /* Hint: '0' is a digit too.  */
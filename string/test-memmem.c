@@ -143,6 +143,33 @@ check1 (void)
 		  pattern, sizeof pattern, exp_result);
 }
 
+/* Many positions match the first and the last byte of the needle, but
+   not the whole needle.  */
+static void
+check2 (void)
+{
+  size_t hs_len = 4096;
+  size_t ne_len = 32;
+  char *haystack = (char *) buf1;
+  char needle[ne_len];
+
+  for (size_t i = 0; i < hs_len; ++i)
+    haystack[i] = i % 2 == 0 ? 'a' : 'b';
+  memset (needle, 'c', ne_len);
+  needle[0] = 'a';
+  needle[ne_len - 1] = 'b';
+
+  /* Put a match at the end of the haystack, which is not found if the
+     last byte is left out.  */
+  memcpy (haystack + hs_len - ne_len, needle, ne_len);
+  FOR_EACH_IMPL (impl, 0)
+    {
+      check_result (impl, haystack, hs_len - 1, needle, ne_len, NULL);
+      check_result (impl, haystack, hs_len, needle, ne_len,
+		    haystack + hs_len - ne_len);
+    }
+}
+
 static const char *const strs[] =
   {
     "00000", "00112233", "0123456789", "0000111100001111",
@@ -159,6 +186,7 @@ test_main (void)
   test_init ();
 
   check1 ();
+  check2 ();
 
   printf ("%23s", "");
   FOR_EACH_IMPL (impl, 0)
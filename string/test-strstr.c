@@ -206,6 +206,37 @@ pr23637 (void)
     check_result (impl, h, n, exp_result);
 }
 
+/* Many positions match the first and the last byte of the needle, but
+   not the whole needle.  */
+static void
+check3 (void)
+{
+  size_t hs_len = 4096;
+  size_t ne_len = 32;
+  char *h = (char *) buf1;
+  char *n = (char *) buf2;
+
+  for (size_t i = 0; i < hs_len; ++i)
+    h[i] = i % 2 == 0 ? 'a' : 'b';
+  h[hs_len] = '\0';
+  memset (n, 'c', ne_len);
+  n[0] = 'a';
+  n[ne_len - 1] = 'b';
+  n[ne_len] = '\0';
+
+  /* Put a match at the end of the haystack.  A needle which differs
+     in the middle is not found.  */
+  memcpy (h + hs_len - ne_len, n, ne_len);
+  char n2[ne_len + 1];
+  strcpy (n2, n);
+  n2[ne_len / 2] = 'd';
+  FOR_EACH_IMPL (impl, 0)
+    {
+      check_result (impl, h, n, h + hs_len - ne_len);
+      check_result (impl, h, n2, NULL);
+    }
+}
+
 static int
 test_main (void)
 {
@@ -214,6 +245,7 @@ test_main (void)
   check1 ();
   check2 ();
   pr23637 ();
+  check3 ();
 
   printf ("%23s", "");
   FOR_EACH_IMPL (impl, 0)
@@ -0,0 +1,169 @@
+/* Test strverscmp against a character-at-a-time implementation.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/next_to_fault.h>
+
+/* strverscmp skips the common prefix of the strings before it runs
+   its state machine.  Compare it with the state machine alone, on
+   strings which differ after prefixes of all lengths and alignments,
+   with digits on both sides of the first difference.  */
+
+#define S_N 0x0
+#define S_I 0x3
+#define S_F 0x6
+#define S_Z 0x9
+#define CMP 2
+#define LEN 3
+
+static int
+isdig (unsigned char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+static int
+simple_strverscmp (const char *s1, const char *s2)
+{
+  const unsigned char *p1 = (const unsigned char *) s1;
+  const unsigned char *p2 = (const unsigned char *) s2;
+  static const uint8_t next_state[] =
+  {
+      S_N, S_I, S_Z,
+      S_N, S_I, S_I,
+      S_N, S_F, S_F,
+      S_N, S_F, S_Z
+  };
+  static const int8_t result_type[] =
+  {
+      CMP, CMP, CMP, CMP, LEN, CMP, CMP, CMP, CMP,
+      CMP, -1,  -1,  +1,  LEN, LEN, +1,  LEN, LEN,
+      CMP, CMP, CMP, CMP, CMP, CMP, CMP, CMP, CMP,
+      CMP, +1,  +1,  -1,  CMP, CMP, -1,  CMP, CMP
+  };
+
+  unsigned char c1 = *p1++;
+  unsigned char c2 = *p2++;
+  int state = S_N + ((c1 == '0') + isdig (c1));
+  int diff;
+  while ((diff = c1 - c2) == 0)
+    {
+      if (c1 == '\0')
+	return diff;
+      state = next_state[state];
+      c1 = *p1++;
+      c2 = *p2++;
+      state += (c1 == '0') + isdig (c1);
+    }
+
+  state = result_type[state * 3 + ((c2 == '0') + isdig (c2))];
+  switch (state)
+    {
+    case CMP:
+      return diff;
+    case LEN:
+      while (isdig (*p1++))
+	if (!isdig (*p2++))
+	  return 1;
+      return isdig (*p2) ? -1 : diff;
+    default:
+      return state;
+    }
+}
+
+static int
+sign (int x)
+{
+  return (x > 0) - (x < 0);
+}
+
+#define MAXLEN 80
+
+static void
+random_string (char *s, size_t len)
+{
+  static const char chars[] = "0000119a.-";
+  for (size_t i = 0; i < len; i++)
+    s[i] = chars[rand () % (sizeof (chars) - 1)];
+  s[len] = '\0';
+}
+
+static void
+check (const char *s1, const char *s2)
+{
+  int expected = sign (simple_strverscmp (s1, s2));
+  if (sign (strverscmp (s1, s2)) != expected
+      || sign (strverscmp (s2, s1)) != -expected)
+    {
+      support_record_failure ();
+      printf ("error: strverscmp (\"%s\", \"%s\") != %d\n",
+	      s1, s2, expected);
+    }
+}
+
+static int
+do_test (void)
+{
+  static char buf1[MAXLEN + 32];
+  static char buf2[MAXLEN + 32];
+  char tmp1[MAXLEN + 1];
+  char tmp2[MAXLEN + 1];
+
+  srand (1);
+  for (int iter = 0; iter < 20000; iter++)
+    {
+      size_t prefix = rand () % (MAXLEN / 2);
+      size_t len1 = prefix + rand () % (MAXLEN / 2);
+      size_t len2 = prefix + rand () % (MAXLEN / 2);
+      random_string (tmp1, len1);
+      random_string (tmp2, len2);
+      memcpy (tmp2, tmp1, prefix);
+
+      /* The same alignment and different alignments.  */
+      size_t align1 = rand () % 16;
+      size_t align2 = iter % 2 == 0 ? align1 : (size_t) rand () % 16;
+      strcpy (buf1 + align1, tmp1);
+      strcpy (buf2 + align2, tmp2);
+      check (buf1 + align1, buf2 + align2);
+      check (buf1 + align1, buf1 + align1 + 1);
+    }
+
+  /* Equal strings which end just before an unmapped page.  */
+  struct support_next_to_fault ntf1 = support_next_to_fault_allocate (64);
+  struct support_next_to_fault ntf2 = support_next_to_fault_allocate (64);
+  for (size_t len = 0; len < 64; len++)
+    {
+      char *s1 = ntf1.buffer + 63 - len;
+      char *s2 = ntf2.buffer + 63 - len;
+      memset (s1, '7', len);
+      memset (s2, '7', len);
+      s1[len] = '\0';
+      s2[len] = '\0';
+      TEST_COMPARE (strverscmp (s1, s2), 0);
+    }
+  support_next_to_fault_free (&ntf1);
+  support_next_to_fault_free (&ntf2);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
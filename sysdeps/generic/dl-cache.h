@@ -220,6 +220,13 @@ enum cache_extension_tag
       size must be a multiple of 4.  */
    cache_extension_tag_glibc_hwcaps,
 
+   /* Hash index of the library names.  A struct cache_name_index,
+      see below.  Lets the dynamic loader find the entries for a name
+      with a single probe instead of a binary search.
+
+      For this section, 4-byte alignment is required.  */
+   cache_extension_tag_name_index,
+
    /* Total number of known cache extension tags.  */
    cache_extension_count
   };
@@ -274,6 +281,49 @@ struct cache_extension_all_loaded
   struct cache_extension_loaded sections[cache_extension_count];
 };
 
+/* Slot in the cache_extension_tag_name_index section.  */
+struct cache_name_index_slot
+{
+  /* dl_cache_name_hash of the name.  */
+  uint32_t hash;
+
+  /* Index of the first and the last entry with the name.  The entries
+     with the same name are adjacent because the entries are sorted by
+     name.  first is UINT32_MAX for an unused slot.  */
+  uint32_t first;
+  uint32_t last;
+};
+
+/* Contents of the cache_extension_tag_name_index section.  Each
+   distinct library name is stored in the first unused slot at or after
+   the slot dl_cache_name_hash (name) & (nslots - 1), wrapping around at
+   the end.  At least one slot is unused.  */
+struct cache_name_index
+{
+  uint32_t nslots;		/* Number of slots, a power of two.  */
+  struct cache_name_index_slot slots[];
+};
+
+/* Hash function for the cache_extension_tag_name_index section.  Names
+   which are equal according to _dl_cache_libcmp have the same hash, so
+   digit sequences are hashed by their numeric value.  */
+static inline uint32_t
+dl_cache_name_hash (const char *name)
+{
+  uint32_t hash = 5381;
+  while (*name != '\0')
+    if (*name >= '0' && *name <= '9')
+      {
+	uint32_t value = 0;
+	while (*name >= '0' && *name <= '9')
+	  value = value * 10 + *name++ - '0';
+	hash = (hash * 33 + value) * 33 + '0';
+      }
+    else
+      hash = hash * 33 + (unsigned char) *name++;
+  return hash;
+}
+
 /* Performs basic data validation based on section tag, and removes
    the sections which are invalid.  */
 static void
@@ -293,6 +343,25 @@ cache_extension_verify (struct cache_extension_all_loaded *loaded)
 	hwcaps->flags = 0;
       }
   }
+
+  {
+    /* The section must be aligned at 4 bytes and contain a power of
+       two number of slots.  */
+    struct cache_extension_loaded *index
+      = &loaded->sections[cache_extension_tag_name_index];
+    const struct cache_name_index *data = index->base;
+    if (index->size < sizeof (struct cache_name_index)
+	|| ((uintptr_t) index->base % 4) != 0
+	|| data->nslots == 0
+	|| (data->nslots & (data->nslots - 1)) != 0
+	|| ((index->size - sizeof (struct cache_name_index))
+	    / sizeof (struct cache_name_index_slot)) != data->nslots)
+      {
+	index->base = NULL;
+	index->size = 0;
+	index->flags = 0;
+      }
+  }
 }
 
 static bool __attribute__ ((unused))
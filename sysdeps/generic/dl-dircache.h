@@ -0,0 +1,70 @@
+/* Cache of directory contents for the shared object search.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_DIRCACHE_H
+#define _DL_DIRCACHE_H
+
+#include <stddef.h>
+
+struct r_search_path_elem;
+
+/* Result of _dl_dircache_lookup.  */
+enum dl_dircache_result
+  {
+    /* The directory could not be listed.  The caller has to try to
+       open the file.  */
+    dl_dircache_unknown,
+    /* The directory has an entry with the requested name.  */
+    dl_dircache_present,
+    /* The directory has no entry with this name.  */
+    dl_dircache_absent,
+  };
+
+#ifdef SHARED
+/* Look up NAME (NAMELEN bytes including the terminating null byte) in
+   the directory whose name are the first DIRNAMELEN bytes of DIRNAME.
+   The directory is identified by the search path element DIR and the
+   hwcaps subdirectory index CNT.  Directories which are searched
+   repeatedly are read once, and their contents are kept until
+   _dl_dircache_release.  */
+enum dl_dircache_result _dl_dircache_lookup
+  (const struct r_search_path_elem *dir, size_t cnt,
+   const char *dirname, size_t dirnamelen,
+   const char *name, size_t namelen) attribute_hidden;
+
+/* Discard the cached directory contents.  This has to be called
+   before any code outside the dynamic linker runs, which could change
+   the directories.  */
+void _dl_dircache_release (void) attribute_hidden;
+#else
+/* Static dlopen does not use the cache.  */
+static inline enum dl_dircache_result
+_dl_dircache_lookup (const struct r_search_path_elem *dir, size_t cnt,
+		     const char *dirname, size_t dirnamelen,
+		     const char *name, size_t namelen)
+{
+  return dl_dircache_unknown;
+}
+
+static inline void
+_dl_dircache_release (void)
+{
+}
+#endif
+
+#endif /* _DL_DIRCACHE_H */
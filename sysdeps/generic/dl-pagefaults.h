@@ -0,0 +1,30 @@
+/* Page fault count for the dynamic linker.  Stub version.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_PAGEFAULTS_H
+#define _DL_PAGEFAULTS_H
+
+/* Return the number of page faults of the process so far, or 0 if it
+   is not known.  */
+static inline unsigned long int
+_dl_pagefaults (void)
+{
+  return 0;
+}
+
+#endif /* _DL_PAGEFAULTS_H */
@@ -194,6 +194,10 @@ struct r_found_version
 
     int hidden;
     const char *filename;
+
+    /* Nonzero if _dl_fixup has already tried to bind the lazy PLT slots
+       for all versions needed from FILENAME.  */
+    int plt_batched;
   };
 
 /* We want to cache information about the searches for shared objects.  */
@@ -442,6 +446,8 @@ struct rtld_global
   EXTERN struct dtv_slotinfo_list
   {
     size_t len;
+    /* Maximum generation counter of the entries in this element.  */
+    size_t gen;
     struct dtv_slotinfo_list *next;
     struct dtv_slotinfo
     {
@@ -474,7 +480,8 @@ struct rtld_global
   EXTERN void (*_dl_init_static_tls) (struct link_map *);
 #endif
 
-  /* Scopes to free after next THREAD_GSCOPE_WAIT ().  */
+  /* Scopes to free after next THREAD_GSCOPE_WAIT (), or once no thread
+     uses the global scope (see _dl_scope_reclaim).  */
   EXTERN struct dl_scope_free_list
   {
     size_t count;
@@ -552,6 +559,7 @@ struct rtld_global_ro
 #define DL_DEBUG_STATISTICS (1 << 7)
 #define DL_DEBUG_UNUSED	    (1 << 8)
 #define DL_DEBUG_SCOPES	    (1 << 9)
+#define DL_DEBUG_PROFILE    (1 << 12)
 /* These two are used only internally.  */
 #define DL_DEBUG_HELP       (1 << 10)
 #define DL_DEBUG_PRELINK    (1 << 11)
@@ -1023,6 +1031,9 @@ enum
     /* Set if dl_lookup is called for non-lazy relocation processing
        from _dl_relocate_object in elf/dl-reloc.c.  */
     DL_LOOKUP_FOR_RELOCATE = 8,
+    /* Set if the symbol is looked up before it is needed, so that a
+       missing definition is not an error.  */
+    DL_LOOKUP_SPECULATIVE = 16,
   };
 
 /* Lookup versioned symbol.  */
@@ -1035,6 +1046,25 @@ extern lookup_t _dl_lookup_symbol_x (const char *undef,
 				     struct link_map *skip_map)
      attribute_hidden;
 
+/* Update the symbol index of SCOPE, if it has one, after objects were
+   added to or removed from it.  Must be called with dl_load_lock
+   held.  */
+extern void _dl_scope_index_update (struct r_scope_elem *scope)
+     attribute_hidden;
+
+/* Free the symbol index of SCOPE.  Must be called with dl_load_lock
+   held.  */
+extern void _dl_scope_index_free (struct r_scope_elem *scope)
+     attribute_hidden;
+
+#ifdef SHARED
+/* Remember the results of global scope lookups in the base namespace
+   between these calls, so that each symbol is only searched once
+   during the initial relocation.  Only used by rtld.  */
+extern void _dl_lookup_memo_start (void) attribute_hidden;
+extern void _dl_lookup_memo_end (void) attribute_hidden;
+#endif
+
 /* Proxy an existing link map entry into a new link map */
 extern struct link_map *_dl_new_proxy (struct link_map *old,
 				       int mode,
@@ -1064,6 +1094,71 @@ extern struct link_map *_dl_new_object (char *realname, const char *libname,
 					int mode, Lmid_t nsid)
      attribute_hidden;
 
+#ifdef SHARED
+/* Nonzero while the initial relocation looks up symbols through the
+   relocation cache (see elf/dl-reloc-cache.c).  */
+extern int _dl_reloc_cache_active attribute_hidden;
+
+/* Read the relocation cache FILE and prepare to replay or record the
+   symbol bindings of the initial relocation.  */
+extern void _dl_reloc_cache_setup (const char *file) attribute_hidden;
+
+/* Stop using the relocation cache and write it if it was outdated.  */
+extern void _dl_reloc_cache_finish (void) attribute_hidden;
+
+/* Like _dl_lookup_symbol_x, but take the result from the relocation
+   cache if possible, and record it otherwise.  */
+extern lookup_t _dl_reloc_cache_lookup (const char *undef,
+					struct link_map *undef_map,
+					const ElfW(Sym) **sym,
+					struct r_scope_elem *symbol_scope[],
+					const struct r_found_version *version,
+					int type_class, int flags)
+     attribute_hidden;
+
+/* Phases of loading an object measured for LD_DEBUG=profile (see
+   elf/dl-load-profile.c).  They index the l_profile arrays.  */
+enum dl_profile_phase
+  {
+    dl_profile_map,
+    dl_profile_reloc,
+    dl_profile_init,
+  };
+
+/* Counters at the start of a phase.  */
+struct dl_profile_start
+{
+  hp_timing_t time;
+  unsigned long int faults;
+  unsigned long int failed_probes;
+};
+
+/* Number of files which could not be opened while searching for
+   objects.  */
+extern unsigned long int _dl_profile_failed_probes attribute_hidden;
+
+/* Record the counters at the start of a phase in *START.  */
+extern void _dl_profile_start (struct dl_profile_start *start)
+     attribute_hidden;
+
+/* Add the time and the counters since *START to PHASE of MAP.  */
+extern void _dl_profile_stop (const struct dl_profile_start *start,
+			      struct link_map *map,
+			      enum dl_profile_phase phase)
+     attribute_hidden;
+
+/* Record the times spent by rtld in total, loading and relocating the
+   initial objects.  */
+extern void _dl_profile_rtld_times (hp_timing_t total, hp_timing_t load,
+				    hp_timing_t relocate)
+     attribute_hidden;
+
+/* Write the profile of the program startup as a JSON document to the
+   debug file descriptor.  Called once after the constructors of the
+   initial objects have run.  */
+extern void _dl_profile_report (void) attribute_hidden;
+#endif
+
 /* Relocate the given object (if it hasn't already been).
    SCOPE is passed to _dl_lookup_symbol in symbol lookups.
    If RTLD_LAZY is set in RELOC-MODE, don't relocate its PLT.  */
@@ -1107,9 +1202,11 @@ extern void _dl_init (struct link_map *main_map, int argc, char **argv,
    initializer functions have completed.  */
 extern void _dl_fini (void) attribute_hidden;
 
-/* Sort array MAPS according to dependencies of the contained objects.  */
+/* Sort array MAPS according to dependencies of the contained objects.
+   If FORCE_FIRST, MAPS[0] keeps its place even if the dependencies
+   would require otherwise.  */
 extern void _dl_sort_maps (struct link_map **maps, unsigned int nmaps,
-			   char *used, bool for_fini) attribute_hidden;
+			   bool force_first, bool for_fini) attribute_hidden;
 
 /* The dynamic linker calls this function before and having changing
    any shared object mappings.  The `r_state' member of `struct r_debug'
@@ -1287,6 +1384,11 @@ extern void *_dl_open (const char *name, int mode, const void *caller,
    old scope, OLD can't be freed until no thread is using it.  */
 extern int _dl_scope_free (void *) attribute_hidden;
 
+/* Free the scopes queued by _dl_scope_free if no thread can use them
+   anymore, without waiting for other threads.  Return nonzero if the
+   queue is empty afterwards.  */
+extern int _dl_scope_reclaim (void) attribute_hidden;
+
 
 /* Add module to slot information data.  If DO_ADD is false, only the
    required memory is allocated.  Must be called with GL
@@ -1297,9 +1399,11 @@ extern int _dl_scope_free (void *) attribute_hidden;
 extern void _dl_add_to_slotinfo (struct link_map *l, bool do_add)
   attribute_hidden;
 
-/* Update slot information data for at least the generation of the
-   module with the given index.  */
-extern struct link_map *_dl_update_slotinfo (unsigned long int req_modid)
+/* Update the dtv of the current thread to generation NEW_GEN, which
+   must be at least the generation of the module with index REQ_MODID.
+   Return the link map of that module if its dtv entry was reset.  */
+extern struct link_map *_dl_update_slotinfo (unsigned long int req_modid,
+					     size_t new_gen)
      attribute_hidden;
 
 /* Look up the module's TLS block as for __tls_get_addr,
@@ -1409,6 +1513,11 @@ __rtld_mutex_init (void)
 void __thread_gscope_wait (void) attribute_hidden;
 # define THREAD_GSCOPE_WAIT() __thread_gscope_wait ()
 
+/* Return true if no other thread uses the global scope at the moment,
+   without waiting.  If so, data which has been unpublished before the
+   call cannot be used by other threads anymore.  */
+bool __thread_gscope_quiescent (void) attribute_hidden;
+
 __END_DECLS
 
 #endif /* ldsodefs.h */
@@ -21,6 +21,7 @@
   "LD_ORIGIN_PATH\0"							      \
   "LD_PRELOAD\0"							      \
   "LD_PROFILE\0"							      \
+  "LD_RELOC_CACHE\0"							      \
   "LD_SHOW_AUXV\0"							      \
   "LD_USE_LOAD_BIAS\0"							      \
   "LOCALDOMAIN\0"							      \
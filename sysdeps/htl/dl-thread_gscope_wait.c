@@ -53,3 +53,30 @@ __thread_gscope_wait (void)
 
   __libc_rwlock_unlock (GL (dl_pthread_threads_lock));
 }
+
+bool
+__thread_gscope_quiescent (void)
+{
+  bool result = true;
+
+  /* Order the update of the scope data before the reads of the flags
+     below.  */
+  atomic_full_barrier ();
+
+  __libc_rwlock_rdlock (GL (dl_pthread_threads_lock));
+
+  for (size_t i = 0; i < GL (dl_pthread_num_threads); ++i)
+    {
+      struct __pthread *t = GL (dl_pthread_threads[i]);
+      if (t != NULL
+	  && atomic_load_relaxed (&t->tcb->gscope_flag)
+	     != THREAD_GSCOPE_FLAG_UNUSED)
+	{
+	  result = false;
+	  break;
+	}
+    }
+
+  __libc_rwlock_unlock (GL (dl_pthread_threads_lock));
+  return result;
+}
@@ -78,3 +78,45 @@ __thread_gscope_wait (void)
 
   lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
 }
+
+bool
+__thread_gscope_quiescent (void)
+{
+  /* Order the update of the scope data before the reads of the flags
+     below.  */
+  atomic_full_barrier ();
+
+  lll_lock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+
+  struct pthread *self = THREAD_SELF;
+  bool result = true;
+
+  list_t *runp;
+  list_for_each (runp, &GL (dl_stack_used))
+    {
+      struct pthread *t = list_entry (runp, struct pthread, list);
+      if (t != self
+	  && atomic_load_relaxed (&t->header.gscope_flag)
+	     != THREAD_GSCOPE_FLAG_UNUSED)
+	{
+	  result = false;
+	  goto out;
+	}
+    }
+
+  list_for_each (runp, &GL (dl_stack_user))
+    {
+      struct pthread *t = list_entry (runp, struct pthread, list);
+      if (t != self
+	  && atomic_load_relaxed (&t->header.gscope_flag)
+	     != THREAD_GSCOPE_FLAG_UNUSED)
+	{
+	  result = false;
+	  goto out;
+	}
+    }
+
+ out:
+  lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+  return result;
+}
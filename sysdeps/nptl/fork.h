@@ -114,6 +114,9 @@ reclaim_stacks (void)
 	      /* Clear the thread-specific data.  */
 	      memset (curp->specific_1stblock, '\0',
 		      sizeof (curp->specific_1stblock));
+	      memset (curp->specific_keys, '\0',
+		      sizeof (curp->specific_keys));
+	      curp->specific_blocks = 0;
 
 	      curp->specific_used = false;
 
@@ -494,6 +494,43 @@ extern int pthread_setaffinity_np (pthread_t __th, size_t __cpusetsize,
 extern int pthread_getaffinity_np (pthread_t __th, size_t __cpusetsize,
 				   cpu_set_t *__cpuset)
      __THROW __nonnull ((3));
+
+
+/* Functions for thread pools.  */
+
+/* Opaque type of a work-stealing thread pool.  */
+typedef struct pthread_pool pthread_pool_t;
+
+/* Create a thread pool with NTHREADS worker threads and store it in
+   *POOL.  If NTHREADS is zero, use one worker per CPU in the affinity
+   set of ATTR, or per online CPU if ATTR has no affinity set.  The
+   workers are created with the attributes in ATTR (if not NULL); if
+   ATTR restricts them to more than one CPU, each worker is bound to one
+   of these CPUs.  */
+extern int pthread_pool_create_np (pthread_pool_t **__pool,
+				   unsigned int __nthreads,
+				   const pthread_attr_t *__attr)
+     __THROW __nonnull ((1));
+
+/* Queue a call to ROUTINE with argument ARG on POOL.  */
+extern int pthread_pool_submit_np (pthread_pool_t *__pool,
+				   void (*__routine) (void *), void *__arg)
+     __THROW __nonnull ((1, 2));
+
+/* Wait until all tasks submitted to POOL, including those submitted by
+   other tasks, have completed.  */
+extern int pthread_pool_wait_np (pthread_pool_t *__pool) __nonnull ((1));
+
+/* Wait for all tasks of POOL to complete, then terminate its worker
+   threads and free POOL.  */
+extern int pthread_pool_destroy_np (pthread_pool_t *__pool) __nonnull ((1));
+
+/* Copy N bytes from SRC to DEST like memcpy, splitting large copies
+   between the calling thread and the workers of POOL.  Return DEST.  */
+extern void *pthread_pool_memcpy_np (pthread_pool_t *__pool,
+				     void *__restrict __dest,
+				     const void *__restrict __src, size_t __n)
+     __nonnull ((1));
 #endif
 
 
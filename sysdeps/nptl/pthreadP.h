@@ -57,6 +57,35 @@ static inline short max_adaptive_count (void)
 #endif
 }
 
+/* Semaphores, barriers and condition variables spin for up to this
+   number of rounds before blocking.  Spinning is off unless it is
+   enabled with the glibc.pthread.wait_spin_count tunable.  */
+static inline short max_wait_spin_count (void)
+{
+#if HAVE_TUNABLES
+  return __mutex_aconf.wait_spin_count;
+#else
+  return 0;
+#endif
+}
+
+/* Semaphores adapt the number of rounds they spin, like
+   PTHREAD_MUTEX_ADAPTIVE_NP mutexes do.  Return the number of rounds to
+   spin given SPINS, the estimate of how many rounds recent waits
+   needed.  */
+static inline int adaptive_spin_limit (int spins)
+{
+  int max_cnt = max_wait_spin_count ();
+  return spins * 2 + 10 < max_cnt ? spins * 2 + 10 : max_cnt;
+}
+
+/* Return the estimate SPINS updated with CNT, the number of rounds the
+   last wait spun.  */
+static inline int adaptive_spin_update (int spins, int cnt)
+{
+  return spins + (cnt - spins) / 8;
+}
+
 
 /* Magic cookie representing robust mutex with dead owner.  */
 #define PTHREAD_MUTEX_INCONSISTENT	INT_MAX
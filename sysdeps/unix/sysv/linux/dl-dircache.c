@@ -0,0 +1,230 @@
+/* Cache of directory contents for the shared object search.  Linux version.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <alloca.h>
+#include <dirent.h>
+#include <dl-dircache.h>
+#include <fcntl.h>
+#include <ldsodefs.h>
+#include <not-cancel.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sysdep.h>
+
+/* open_path tries to open the shared object in every directory of a
+   search path, and in every hwcaps subdirectory of it.  Most of these
+   attempts fail with ENOENT.  A directory which is searched several
+   times while objects are loaded is instead read once with
+   getdents64, and its file names are kept in a hash table, so that
+   only files which exist are opened.
+
+   The contents are only kept while objects are loaded, that is, until
+   dl_main is finished or the dlopen call is ready to run the ELF
+   constructors.  The directories can change afterwards.  */
+
+/* Directories with more data than this are not cached.  Lookups in
+   them fall back to opening the file.  */
+#define DIRCACHE_MAX_DATA (1024 * 1024)
+
+/* Maximum number of directories tracked at the same time.  */
+#define DIRCACHE_NDIRS 64
+
+/* Reading a directory costs more than a failed open.  Only read it
+   when it is searched for this many names.  */
+#define DIRCACHE_MIN_PROBES 3
+
+struct dircache_slot
+{
+  uint32_t hash;
+  /* Offset of the directory entry plus one, or zero for an unused
+     slot.  */
+  uint32_t offset;
+};
+
+struct dircache_dir
+{
+  /* The search path element and the hwcaps subdirectory index.  */
+  const struct r_search_path_elem *dir;
+  size_t cnt;
+  /* Number of lookups in this directory so far.  */
+  unsigned int probes;
+  /* The mapping holds the entries as returned by getdents64, followed
+     by the hash table.  It is NULL if the directory has not been
+     read.  */
+  char *map;
+  size_t mapsize;
+  const struct dircache_slot *slots;
+  uint32_t mask;
+};
+
+static struct dircache_dir dircache[DIRCACHE_NDIRS];
+static size_t dircache_used;
+
+static inline uint32_t
+dircache_hash (const char *name, size_t len)
+{
+  uint32_t hash = 5381;
+  for (size_t i = 0; i < len; ++i)
+    hash = hash * 33 + (unsigned char) name[i];
+  return hash;
+}
+
+/* Read the directory DIRNAME into *D.  */
+static void
+dircache_fill (struct dircache_dir *d, const char *dirname)
+{
+  int fd = __open64_nocancel (dirname, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd == -1)
+    return;
+
+  /* Only the pages which are used are backed by memory.  The rest is
+     unmapped below.  */
+  char *map = __mmap (NULL, DIRCACHE_MAX_DATA, PROT_READ | PROT_WRITE,
+		      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED)
+    {
+      __close_nocancel (fd);
+      return;
+    }
+
+  size_t length = 0;
+  while (true)
+    {
+      if (DIRCACHE_MAX_DATA - length < sizeof (struct dirent64))
+	goto fail;
+      long int n = INTERNAL_SYSCALL_CALL (getdents64, fd, map + length,
+					  DIRCACHE_MAX_DATA - length);
+      if (INTERNAL_SYSCALL_ERROR_P (n))
+	goto fail;
+      if (n == 0)
+	break;
+      length += n;
+    }
+  __close_nocancel (fd);
+
+  size_t nentries = 0;
+  for (size_t off = 0; off < length;
+       off += ((struct dirent64 *) (map + off))->d_reclen)
+    ++nentries;
+
+  uint32_t nslots = 16;
+  while (nslots < 2 * nentries)
+    nslots *= 2;
+
+  size_t tableoff = ALIGN_UP (length, __alignof__ (struct dircache_slot));
+  size_t tableend = tableoff + nslots * sizeof (struct dircache_slot);
+  if (tableend > DIRCACHE_MAX_DATA)
+    {
+      __munmap (map, DIRCACHE_MAX_DATA);
+      return;
+    }
+  size_t mapsize = ALIGN_UP (tableend, GLRO(dl_pagesize));
+  if (mapsize < DIRCACHE_MAX_DATA)
+    __munmap (map + mapsize, DIRCACHE_MAX_DATA - mapsize);
+
+  struct dircache_slot *slots = (struct dircache_slot *) (map + tableoff);
+  uint32_t mask = nslots - 1;
+  for (size_t off = 0; off < length;
+       off += ((struct dirent64 *) (map + off))->d_reclen)
+    {
+      const char *name = ((struct dirent64 *) (map + off))->d_name;
+      uint32_t hash = dircache_hash (name, strlen (name));
+      uint32_t i = hash & mask;
+      while (slots[i].offset != 0)
+	i = (i + 1) & mask;
+      slots[i].hash = hash;
+      slots[i].offset = off + 1;
+    }
+
+  d->map = map;
+  d->mapsize = mapsize;
+  d->slots = slots;
+  d->mask = mask;
+  return;
+
+ fail:
+  __close_nocancel (fd);
+  __munmap (map, DIRCACHE_MAX_DATA);
+}
+
+enum dl_dircache_result
+_dl_dircache_lookup (const struct r_search_path_elem *dir, size_t cnt,
+		     const char *dirname, size_t dirnamelen,
+		     const char *name, size_t namelen)
+{
+  /* Leave it to open_path to find out whether the directory exists.
+     Relative directories depend on the current directory.  */
+  if (dir->status[cnt] != existing || dirname[0] != '/')
+    return dl_dircache_unknown;
+
+  struct dircache_dir *d = NULL;
+  for (size_t i = 0; i < dircache_used; ++i)
+    if (dircache[i].dir == dir && dircache[i].cnt == cnt)
+      {
+	d = &dircache[i];
+	break;
+      }
+
+  if (d == NULL)
+    {
+      if (dircache_used == DIRCACHE_NDIRS)
+	return dl_dircache_unknown;
+      d = &dircache[dircache_used++];
+      d->dir = dir;
+      d->cnt = cnt;
+      d->probes = 0;
+      d->map = NULL;
+    }
+
+  if (d->map == NULL)
+    {
+      /* Read the directory once, and only if it is searched often
+	 enough.  If this fails, do not try again.  */
+      if (++d->probes != DIRCACHE_MIN_PROBES)
+	return dl_dircache_unknown;
+
+      char *copy = alloca (dirnamelen + 1);
+      *((char *) __mempcpy (copy, dirname, dirnamelen)) = '\0';
+      dircache_fill (d, copy);
+      if (d->map == NULL)
+	return dl_dircache_unknown;
+    }
+
+  uint32_t hash = dircache_hash (name, namelen - 1);
+  for (uint32_t i = hash & d->mask; d->slots[i].offset != 0;
+       i = (i + 1) & d->mask)
+    if (d->slots[i].hash == hash)
+      {
+	const struct dirent64 *e
+	  = (const struct dirent64 *) (d->map + d->slots[i].offset - 1);
+	if (memcmp (e->d_name, name, namelen) == 0)
+	  return dl_dircache_present;
+      }
+
+  return dl_dircache_absent;
+}
+
+void
+_dl_dircache_release (void)
+{
+  for (size_t i = 0; i < dircache_used; ++i)
+    if (dircache[i].map != NULL)
+      __munmap (dircache[i].map, dircache[i].mapsize);
+  dircache_used = 0;
+}
@@ -0,0 +1,41 @@
+/* Page fault count for the dynamic linker.  Linux version.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_PAGEFAULTS_H
+#define _DL_PAGEFAULTS_H
+
+#include <sys/resource.h>
+#include <sysdep.h>
+#include <tv32-compat.h>
+
+/* Return the number of minor and major page faults of the process so
+   far, or 0 if it is not known.  */
+static inline unsigned long int
+_dl_pagefaults (void)
+{
+#if __KERNEL_OLD_TIMEVAL_MATCHES_TIMEVAL64
+  struct __rusage64 usage;
+#else
+  struct __rusage32 usage;
+#endif
+  if (INTERNAL_SYSCALL_CALL (getrusage, RUSAGE_SELF, &usage) != 0)
+    return 0;
+  return usage.ru_minflt + usage.ru_majflt;
+}
+
+#endif /* _DL_PAGEFAULTS_H */
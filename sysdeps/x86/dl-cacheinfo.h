@@ -16,6 +16,10 @@
    License along with the GNU C Library; if not, see
    <https://www.gnu.org/licenses/>.  */
 
+#if defined SHARED && HAVE_TUNABLES
+# include <dl-thresholds-profile.h>
+#endif
+
 static const struct intel_02_cache_info
 {
   unsigned char idx;
@@ -694,6 +698,19 @@ intel_bug_no_cache_info:
   *threads_ptr = threads;
 }
 
+#if HAVE_TUNABLES
+/* The value of x86_rep_stosb_threshold if it has been set, zero
+   otherwise.  TUNABLE_GET only calls the callback for tunables which
+   have been set.  */
+static long int rep_stosb_threshold_tunable;
+
+static void
+TUNABLE_CALLBACK (set_x86_rep_stosb_threshold) (tunable_val_t *valp)
+{
+  rep_stosb_threshold_tunable = (long int) valp->numval;
+}
+#endif
+
 static void
 dl_init_cacheinfo (struct cpu_features *cpu_features)
 {
@@ -896,6 +913,23 @@ dl_init_cacheinfo (struct cpu_features *cpu_features)
   if (CPU_FEATURE_USABLE_P (cpu_features, FSRM))
     rep_movsb_threshold = 2112;
 
+  /* The default threshold to use Enhanced REP STOSB.  */
+  unsigned long int rep_stosb_threshold = 2048;
+
+#if defined SHARED && HAVE_TUNABLES
+  /* Thresholds measured on this processor model replace the defaults
+     above.  The tunables below still take precedence.  Static
+     executables do not read the profile.  */
+  struct thresholds_profile profile;
+  dl_read_thresholds_profile (cpu_features, &profile);
+  if (profile.non_temporal_threshold != 0)
+    non_temporal_threshold = profile.non_temporal_threshold;
+  if (profile.rep_movsb_threshold > minimum_rep_movsb_threshold)
+    rep_movsb_threshold = profile.rep_movsb_threshold;
+  if (profile.rep_stosb_threshold != 0)
+    rep_stosb_threshold = profile.rep_stosb_threshold;
+#endif
+
   unsigned long int rep_movsb_stop_threshold;
   /* ERMS feature is implemented from AMD Zen3 architecture and it is
      performing poorly for data above L2 cache size. Henceforth, adding
@@ -907,9 +941,10 @@ dl_init_cacheinfo (struct cpu_features *cpu_features)
      non-temporal threshold for architectures other than AMD.  */
   else
     rep_movsb_stop_threshold = non_temporal_threshold;
-
-  /* The default threshold to use Enhanced REP STOSB.  */
-  unsigned long int rep_stosb_threshold = 2048;
+#if defined SHARED && HAVE_TUNABLES
+  if (profile.rep_movsb_stop_threshold != 0)
+    rep_movsb_stop_threshold = profile.rep_movsb_stop_threshold;
+#endif
 
 #if HAVE_TUNABLES
   long int tunable_size;
@@ -935,9 +970,12 @@ dl_init_cacheinfo (struct cpu_features *cpu_features)
 
   /* NB: The default value of the x86_rep_stosb_threshold tunable is the
      same as the default value of __x86_rep_stosb_threshold and the
-     minimum value is fixed.  */
-  rep_stosb_threshold = TUNABLE_GET (x86_rep_stosb_threshold,
-				     long int, NULL);
+     minimum value is fixed.  A value from the profile is only replaced
+     if the tunable has been set.  */
+  TUNABLE_GET (x86_rep_stosb_threshold, long int,
+	       TUNABLE_CALLBACK (set_x86_rep_stosb_threshold));
+  if (rep_stosb_threshold_tunable != 0)
+    rep_stosb_threshold = rep_stosb_threshold_tunable;
 
   TUNABLE_SET_WITH_BOUNDS (x86_data_cache_size, data, 0, SIZE_MAX);
   TUNABLE_SET_WITH_BOUNDS (x86_shared_cache_size, shared, 0, SIZE_MAX);
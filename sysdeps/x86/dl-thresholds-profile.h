@@ -0,0 +1,213 @@
+/* Read memcpy and memset thresholds from a calibration profile.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <array_length.h>
+#include <ldsodefs.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/* The profile is a text file with the thresholds measured on one or
+   more processor models, usually written by the bench-x86-thresholds
+   benchmark:
+
+     # Comment.
+     cpu intel 6 0x8f
+     non_temporal_threshold 0x300000
+     rep_movsb_threshold 4096
+     rep_stosb_threshold 2048
+     rep_movsb_stop_threshold 0x300000
+
+   A "cpu" line with the vendor (intel, amd or zhaoxin), family, model
+   and an optional stepping starts a section.  The thresholds in the
+   section are only used if they match the values in
+   cpu_features->basic, that is the family and model computed from
+   CPUID, so a profile copied to another machine has no effect there.
+   Numbers are decimal or hexadecimal with a 0x prefix.  Unknown keys
+   and malformed lines are ignored, and later lines override earlier
+   ones.  */
+
+/* The thresholds read from the profile.  Zero means not set.  */
+struct thresholds_profile
+{
+  unsigned long int non_temporal_threshold;
+  unsigned long int rep_movsb_threshold;
+  unsigned long int rep_stosb_threshold;
+  unsigned long int rep_movsb_stop_threshold;
+};
+
+struct profile_word
+{
+  const char *start;
+  size_t length;
+};
+
+static bool
+profile_word_is (const struct profile_word *word, const char *expected)
+{
+  return (word->length == strlen (expected)
+	  && memcmp (word->start, expected, word->length) == 0);
+}
+
+/* Parse WORD as a decimal or hexadecimal number.  Return false if it is
+   not a number or if it is out of range.  */
+static bool
+profile_parse_number (const struct profile_word *word,
+		      unsigned long int *result)
+{
+  const char *p = word->start;
+  const char *end = p + word->length;
+  unsigned int base = 10;
+  if (end - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+    {
+      base = 16;
+      p += 2;
+    }
+  if (p == end)
+    return false;
+
+  unsigned long int value = 0;
+  for (; p < end; ++p)
+    {
+      unsigned int digit;
+      if (*p >= '0' && *p <= '9')
+	digit = *p - '0';
+      else if (base == 16 && (*p | 0x20) >= 'a' && (*p | 0x20) <= 'f')
+	digit = (*p | 0x20) - 'a' + 10;
+      else
+	return false;
+      if (value > (ULONG_MAX - digit) / base)
+	return false;
+      value = value * base + digit;
+    }
+
+  *result = value;
+  return true;
+}
+
+/* Return true if the "cpu" line in WORDS matches the processor.  */
+static bool
+profile_cpu_matches (const struct cpu_features *cpu_features,
+		     const struct profile_word *words, size_t nwords)
+{
+  if (nwords != 4 && nwords != 5)
+    return false;
+
+  const char *vendor;
+  switch (cpu_features->basic.kind)
+    {
+    case arch_kind_intel:
+      vendor = "intel";
+      break;
+    case arch_kind_amd:
+      vendor = "amd";
+      break;
+    case arch_kind_zhaoxin:
+      vendor = "zhaoxin";
+      break;
+    default:
+      return false;
+    }
+
+  unsigned long int family, model, stepping;
+  return (profile_word_is (&words[1], vendor)
+	  && profile_parse_number (&words[2], &family)
+	  && family == cpu_features->basic.family
+	  && profile_parse_number (&words[3], &model)
+	  && model == cpu_features->basic.model
+	  && (nwords == 4
+	      || (profile_parse_number (&words[4], &stepping)
+		  && stepping == cpu_features->basic.stepping)));
+}
+
+/* Set the thresholds in PROFILE from the sections of the profile file
+   which match the processor.  PROFILE is cleared first.  */
+static void
+dl_read_thresholds_profile (const struct cpu_features *cpu_features,
+			    struct thresholds_profile *profile)
+{
+  memset (profile, 0, sizeof (*profile));
+
+  /* There is no default profile, so that processes which do not use
+     one are not slowed down by trying to open it.  */
+  const char *file = TUNABLE_GET (x86_thresholds_file, const char *, NULL);
+  if (file == NULL || file[0] == '\0')
+    return;
+
+  size_t size;
+  const char *data = _dl_sysdep_read_whole_file (file, &size, PROT_READ);
+  if (data == MAP_FAILED)
+    return;
+
+  const char *p = data;
+  const char *end = data + size;
+  bool matches = false;
+  while (p < end)
+    {
+      /* Split the line into words.  A comment ends the line.  */
+      struct profile_word words[5];
+      size_t nwords = 0;
+      bool comment = false;
+      while (p < end && *p != '\n')
+	{
+	  if (*p == ' ' || *p == '\t' || *p == '\r' || comment)
+	    {
+	      ++p;
+	      continue;
+	    }
+	  if (*p == '#')
+	    {
+	      comment = true;
+	      continue;
+	    }
+	  const char *start = p;
+	  while (p < end && *p != ' ' && *p != '\t' && *p != '\r'
+		 && *p != '\n' && *p != '#')
+	    ++p;
+	  /* Too many words make the line invalid, which is detected by
+	     NWORDS exceeding the number of words of any valid line.  */
+	  if (nwords < array_length (words))
+	    words[nwords] = (struct profile_word) { start, p - start };
+	  ++nwords;
+	}
+      ++p;
+
+      if (nwords == 0)
+	continue;
+      if (profile_word_is (&words[0], "cpu"))
+	{
+	  matches = profile_cpu_matches (cpu_features, words, nwords);
+	  continue;
+	}
+
+      unsigned long int value;
+      if (!matches || nwords != 2 || !profile_parse_number (&words[1], &value))
+	continue;
+      if (profile_word_is (&words[0], "non_temporal_threshold"))
+	profile->non_temporal_threshold = value;
+      else if (profile_word_is (&words[0], "rep_movsb_threshold"))
+	profile->rep_movsb_threshold = value;
+      else if (profile_word_is (&words[0], "rep_stosb_threshold"))
+	profile->rep_stosb_threshold = value;
+      else if (profile_word_is (&words[0], "rep_movsb_stop_threshold"))
+	profile->rep_movsb_stop_threshold = value;
+    }
+
+  __munmap ((void *) data, size);
+}
@@ -21,13 +21,17 @@
 #include <hle.h>
 #include <elision-conf.h>
 #include <atomic.h>
+#include <stap-probe.h>
 
 
-/* Adapt elision with ADAPT_COUNT and STATUS and decide retries.  */
+/* Adapt elision with ADAPT_COUNT and STATUS and decide retries.
+   ADAPT_COUNT identifies the lock, so the elision_abort probe can be used
+   to monitor abort rates per lock.  */
 
 static inline bool
 elision_adapt(signed char *adapt_count, unsigned int status)
 {
+  LIBC_PROBE (elision_abort, 2, adapt_count, status);
   if (status & _XABORT_RETRY)
     return false;
   if ((status & _XABORT_EXPLICIT)
@@ -0,0 +1,81 @@
+/* Test case for iconv inside a transactionally executing RTM region.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <iconv.h>
+#include <wchar.h>
+#include <tst-string-rtm.h>
+
+#define LOOP 3000
+#define STRING_SIZE 1024
+char string1[STRING_SIZE];
+wchar_t wstring[STRING_SIZE];
+char string2[STRING_SIZE];
+iconv_t to_wchar;
+iconv_t from_wchar;
+
+/* Convert string1 to wstring and back to string2 with the UTF-8 bulk
+   conversions.  */
+static int
+convert (void)
+{
+  char *inbuf = string1;
+  size_t inleft = STRING_SIZE;
+  char *outbuf = (char *) wstring;
+  size_t outleft = sizeof (wstring);
+  if (iconv (to_wchar, &inbuf, &inleft, &outbuf, &outleft) != 0
+      || inleft != 0 || outleft != 0)
+    return 1;
+
+  inbuf = (char *) wstring;
+  inleft = sizeof (wstring);
+  outbuf = string2;
+  outleft = STRING_SIZE;
+  if (iconv (from_wchar, &inbuf, &inleft, &outbuf, &outleft) != 0
+      || inleft != 0 || outleft != 0)
+    return 1;
+
+  return memcmp (string1, string2, STRING_SIZE) != 0;
+}
+
+__attribute__ ((noinline, noclone))
+static int
+prepare (void)
+{
+  to_wchar = iconv_open ("WCHAR_T", "UTF-8");
+  from_wchar = iconv_open ("UTF-8", "WCHAR_T");
+  if (to_wchar == (iconv_t) -1 || from_wchar == (iconv_t) -1)
+    return EXIT_FAILURE;
+  memset (string1, 'a', STRING_SIZE);
+  if (convert () == 0 && wstring[STRING_SIZE - 1] == L'a')
+    return EXIT_SUCCESS;
+  else
+    return EXIT_FAILURE;
+}
+
+__attribute__ ((noinline, noclone))
+static int
+function (void)
+{
+  return convert ();
+}
+
+static int
+do_test (void)
+{
+  return do_test_1 ("iconv", LOOP, prepare, function);
+}
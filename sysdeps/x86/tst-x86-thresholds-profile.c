@@ -0,0 +1,173 @@
+/* Test reading memcpy and memset thresholds from a calibration profile.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The thresholds used by the dynamic linker are read from the output
+   of "ld.so --list-diagnostics", which also provides the family and
+   model the profile sections have to match.  */
+
+#include <cpu-features.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/capture_subprocess.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/temp_file.h>
+#include <support/xunistd.h>
+#include <unistd.h>
+
+struct diagnostics
+{
+  unsigned long int kind;
+  unsigned long int family;
+  unsigned long int model;
+  unsigned long int stepping;
+  unsigned long int non_temporal_threshold;
+  unsigned long int rep_movsb_threshold;
+  unsigned long int rep_stosb_threshold;
+  unsigned long int rep_movsb_stop_threshold;
+};
+
+/* Return the value of the x86.cpu_features.NAME line in OUTPUT.  */
+static unsigned long int
+diagnostics_value (const char *output, const char *name)
+{
+  char *key = xasprintf ("\nx86.cpu_features.%s=", name);
+  const char *p = strstr (output, key);
+  if (p == NULL)
+    FAIL_EXIT1 ("no %s in ld.so --list-diagnostics output", name);
+  unsigned long int value = strtoul (p + strlen (key), NULL, 0);
+  free (key);
+  return value;
+}
+
+/* Run ld.so --list-diagnostics with GLIBC_TUNABLES set to TUNABLES.  */
+static struct diagnostics
+run_ldso (const char *tunables)
+{
+  printf ("info: GLIBC_TUNABLES=%s\n", tunables);
+  TEST_COMPARE (setenv ("GLIBC_TUNABLES", tunables, 1), 0);
+  char *argv[] = { (char *) support_objdir_elf_ldso,
+		   (char *) "--list-diagnostics", NULL };
+  struct support_capture_subprocess result
+    = support_capture_subprogram (support_objdir_elf_ldso, argv);
+  support_capture_subprocess_check (&result, "ld.so --list-diagnostics", 0,
+				    sc_allow_stdout);
+
+  struct diagnostics d;
+  const char *out = result.out.buffer;
+  d.kind = diagnostics_value (out, "basic.kind");
+  d.family = diagnostics_value (out, "basic.family");
+  d.model = diagnostics_value (out, "basic.model");
+  d.stepping = diagnostics_value (out, "basic.stepping");
+  d.non_temporal_threshold
+    = diagnostics_value (out, "non_temporal_threshold");
+  d.rep_movsb_threshold = diagnostics_value (out, "rep_movsb_threshold");
+  d.rep_stosb_threshold = diagnostics_value (out, "rep_stosb_threshold");
+  d.rep_movsb_stop_threshold
+    = diagnostics_value (out, "rep_movsb_stop_threshold");
+  support_capture_subprocess_free (&result);
+  return d;
+}
+
+static int
+do_test (void)
+{
+  struct diagnostics defaults = run_ldso ("");
+
+  const char *vendor;
+  switch (defaults.kind)
+    {
+    case arch_kind_intel:
+      vendor = "intel";
+      break;
+    case arch_kind_amd:
+      vendor = "amd";
+      break;
+    case arch_kind_zhaoxin:
+      vendor = "zhaoxin";
+      break;
+    default:
+      FAIL_UNSUPPORTED ("processor vendor not supported by profiles");
+    }
+
+  /* The values are different from any defaults.  The sections for
+     another model and another stepping must be ignored.  */
+  char *profile;
+  int fd = create_temp_file ("tst-x86-thresholds-profile-", &profile);
+  TEST_VERIFY_EXIT (fd >= 0);
+  char *contents = xasprintf ("# Test profile.\n"
+			      "cpu %s %#lx %#lx\n"
+			      "non_temporal_threshold 0x345000\n"
+			      "rep_movsb_threshold 12288 # Comment.\n"
+			      "\trep_stosb_threshold   0x1800\n"
+			      "rep_movsb_stop_threshold 0x234000\n"
+			      "unknown_threshold 1\n"
+			      "cpu %s %lu %lu\n"
+			      "rep_stosb_threshold 0x4321\n"
+			      "cpu %s %lu %lu %lu\n"
+			      "non_temporal_threshold 0x4321\n",
+			      vendor, defaults.family, defaults.model,
+			      vendor, defaults.family + 1, defaults.model,
+			      vendor, defaults.family, defaults.model,
+			      defaults.stepping + 1);
+  TEST_COMPARE (write (fd, contents, strlen (contents)),
+		(ssize_t) strlen (contents));
+  xclose (fd);
+
+  char *tunables = xasprintf ("glibc.cpu.x86_thresholds_file=%s", profile);
+  struct diagnostics d = run_ldso (tunables);
+  TEST_COMPARE (d.non_temporal_threshold, 0x345000);
+  TEST_COMPARE (d.rep_movsb_threshold, 12288);
+  TEST_COMPARE (d.rep_stosb_threshold, 0x1800);
+  TEST_COMPARE (d.rep_movsb_stop_threshold, 0x234000);
+  free (tunables);
+
+  /* The tunables take precedence over the profile.  */
+  tunables = xasprintf ("glibc.cpu.x86_thresholds_file=%s"
+			":glibc.cpu.x86_non_temporal_threshold=0x123000"
+			":glibc.cpu.x86_rep_stosb_threshold=0x999",
+			profile);
+  d = run_ldso (tunables);
+  TEST_COMPARE (d.non_temporal_threshold, 0x123000);
+  TEST_COMPARE (d.rep_movsb_threshold, 12288);
+  TEST_COMPARE (d.rep_stosb_threshold, 0x999);
+  free (tunables);
+
+  /* So does a tunable set to its default value.  */
+  tunables = xasprintf ("glibc.cpu.x86_thresholds_file=%s"
+			":glibc.cpu.x86_rep_stosb_threshold=2048",
+			profile);
+  d = run_ldso (tunables);
+  TEST_COMPARE (d.rep_stosb_threshold, 2048);
+  free (tunables);
+
+  /* A profile which does not exist leaves the defaults in place.  */
+  d = run_ldso ("glibc.cpu.x86_thresholds_file=/nonexistent");
+  TEST_COMPARE (d.non_temporal_threshold, defaults.non_temporal_threshold);
+  TEST_COMPARE (d.rep_movsb_threshold, defaults.rep_movsb_threshold);
+  TEST_COMPARE (d.rep_stosb_threshold, defaults.rep_stosb_threshold);
+  TEST_COMPARE (d.rep_movsb_stop_threshold,
+		defaults.rep_movsb_stop_threshold);
+
+  free (contents);
+  free (profile);
+  return 0;
+}
+
+#include <support/test-driver.c>
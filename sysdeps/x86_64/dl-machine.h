@@ -238,6 +238,17 @@ elf_machine_plt_value (struct link_map *map, const ElfW(Rela) *reloc,
   return value;
 }
 
+/* _dl_fixup can resolve lazy PLT slots ahead of their first call.  */
+#define ELF_MACHINE_PLT_BATCH 1
+
+/* Return true if the GOT entry at RELOC_ADDR of MAP still points to
+   the PLT entry of MAP, which enters the lazy binding trampoline.  */
+static inline bool
+elf_machine_plt_lazy_p (struct link_map *map, const ElfW(Addr) *reloc_addr)
+{
+  return *reloc_addr >= map->l_map_start && *reloc_addr < map->l_map_end;
+}
+
 
 /* Names of the architecture-specific auditing callback functions.  */
 #define ARCH_LA_PLTENTER x86_64_gnu_pltenter
@@ -0,0 +1,25 @@
+/* Bulk UTF-8 conversion optimized with AVX512 instructions.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#define VEC_SIZE 64
+#define BULK_UTF8_INTERNAL __gconv_bulk_utf8_internal_avx512
+#define BULK_INTERNAL_UTF8 __gconv_bulk_internal_utf8_avx512
+#define BULK_UTF8_INTERNAL_RTM __gconv_bulk_utf8_internal_avx512_rtm
+#define BULK_INTERNAL_UTF8_RTM __gconv_bulk_internal_utf8_avx512_rtm
+
+#include "gconv_bulk-vec.h"
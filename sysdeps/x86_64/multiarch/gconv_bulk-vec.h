@@ -0,0 +1,266 @@
+/* Bulk conversion between UTF-8 and INTERNAL with SSE4.1, AVX2 or
+   AVX512 intrinsics.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <immintrin.h>
+#include <stdint.h>
+#include <string.h>
+
+/* A block is VEC_SIZE characters: one vector of UTF-8 input, which is
+   widened to four vectors of INTERNAL output, or four vectors of
+   INTERNAL input, which are narrowed to one vector of UTF-8 output.
+   If a block is not all ASCII, the groups of VEC_SIZE / 4 characters
+   before the first non-ASCII one, which make up whole vectors of
+   INTERNAL, are still converted.
+
+   BULK_UTF8_INTERNAL_RTM and BULK_INTERNAL_UTF8_RTM, if defined, are
+   the names of the versions for processors with RTM.  They use the
+   SSE4.1 versions inside a transaction.  */
+
+#define ASCII_BLOCK VEC_SIZE
+
+#if VEC_SIZE == 16
+typedef __m128i vec_t;
+# define load(p) _mm_loadu_si128 ((const vec_t *) (p))
+# define store(p, v) _mm_storeu_si128 ((vec_t *) (p), v)
+
+/* Return a mask with bit I set if byte I of V is not ASCII.  */
+static __always_inline uint64_t
+byte_mask (vec_t v)
+{
+  return _mm_movemask_epi8 (v);
+}
+
+/* Return a mask with bit I set if element I of V is not ASCII.  */
+static __always_inline uint64_t
+element_mask (vec_t v)
+{
+  vec_t high = _mm_and_si128 (v, _mm_set1_epi32 (~0x7f));
+  vec_t ascii = _mm_cmpeq_epi32 (high, _mm_setzero_si128 ());
+  return ~_mm_movemask_ps (_mm_castsi128_ps (ascii)) & 0xf;
+}
+
+/* Store the first GROUPS groups of bytes of V, zero-extended to 32
+   bits, at OUT.  */
+static __always_inline void
+widen (unsigned char *out, vec_t v, unsigned int groups)
+{
+  if (groups > 0)
+    store (out, _mm_cvtepu8_epi32 (v));
+  if (groups > 1)
+    store (out + 16, _mm_cvtepu8_epi32 (_mm_srli_si128 (v, 4)));
+  if (groups > 2)
+    store (out + 32, _mm_cvtepu8_epi32 (_mm_srli_si128 (v, 8)));
+  if (groups > 3)
+    store (out + 48, _mm_cvtepu8_epi32 (_mm_srli_si128 (v, 12)));
+}
+
+/* Store the elements of V, which are ASCII, as bytes at OUT.  */
+static __always_inline void
+narrow_group (unsigned char *out, vec_t v)
+{
+  vec_t packed = _mm_packus_epi16 (_mm_packus_epi32 (v, v), v);
+  uint32_t word = _mm_cvtsi128_si32 (packed);
+  memcpy (out, &word, sizeof (word));
+}
+
+/* Store the elements of V0 to V3, which are ASCII, as bytes at OUT.  */
+static __always_inline void
+narrow (unsigned char *out, vec_t v0, vec_t v1, vec_t v2, vec_t v3)
+{
+  store (out, _mm_packus_epi16 (_mm_packus_epi32 (v0, v1),
+				_mm_packus_epi32 (v2, v3)));
+}
+#elif VEC_SIZE == 32
+typedef __m256i vec_t;
+# define load(p) _mm256_loadu_si256 ((const vec_t *) (p))
+# define store(p, v) _mm256_storeu_si256 ((vec_t *) (p), v)
+
+static __always_inline uint64_t
+byte_mask (vec_t v)
+{
+  return (uint32_t) _mm256_movemask_epi8 (v);
+}
+
+static __always_inline uint64_t
+element_mask (vec_t v)
+{
+  vec_t high = _mm256_and_si256 (v, _mm256_set1_epi32 (~0x7f));
+  vec_t ascii = _mm256_cmpeq_epi32 (high, _mm256_setzero_si256 ());
+  return ~_mm256_movemask_ps (_mm256_castsi256_ps (ascii)) & 0xff;
+}
+
+static __always_inline void
+widen (unsigned char *out, vec_t v, unsigned int groups)
+{
+  __m128i lo = _mm256_castsi256_si128 (v);
+  __m128i hi = _mm256_extracti128_si256 (v, 1);
+  if (groups > 0)
+    store (out, _mm256_cvtepu8_epi32 (lo));
+  if (groups > 1)
+    store (out + 32, _mm256_cvtepu8_epi32 (_mm_srli_si128 (lo, 8)));
+  if (groups > 2)
+    store (out + 64, _mm256_cvtepu8_epi32 (hi));
+  if (groups > 3)
+    store (out + 96, _mm256_cvtepu8_epi32 (_mm_srli_si128 (hi, 8)));
+}
+
+static __always_inline void
+narrow_group (unsigned char *out, vec_t v)
+{
+  __m128i lo = _mm256_castsi256_si128 (v);
+  __m128i hi = _mm256_extracti128_si256 (v, 1);
+  __m128i packed = _mm_packus_epi16 (_mm_packus_epi32 (lo, hi), lo);
+  _mm_storel_epi64 ((__m128i *) out, packed);
+}
+
+static __always_inline void
+narrow (unsigned char *out, vec_t v0, vec_t v1, vec_t v2, vec_t v3)
+{
+  /* The packs work within 128-bit lanes, so the result holds the low
+     halves of V0 to V3 in the low lane and their high halves in the high
+     lane.  */
+  vec_t packed = _mm256_packus_epi16 (_mm256_packus_epi32 (v0, v1),
+				      _mm256_packus_epi32 (v2, v3));
+  store (out, _mm256_permutevar8x32_epi32 (packed,
+					   _mm256_setr_epi32 (0, 4, 1, 5,
+							      2, 6, 3, 7)));
+}
+#elif VEC_SIZE == 64
+typedef __m512i vec_t;
+# define load(p) _mm512_loadu_si512 (p)
+# define store(p, v) _mm512_storeu_si512 (p, v)
+
+static __always_inline uint64_t
+byte_mask (vec_t v)
+{
+  return _mm512_movepi8_mask (v);
+}
+
+static __always_inline uint64_t
+element_mask (vec_t v)
+{
+  return _mm512_test_epi32_mask (v, _mm512_set1_epi32 (~0x7f));
+}
+
+static __always_inline void
+widen (unsigned char *out, vec_t v, unsigned int groups)
+{
+  if (groups > 0)
+    store (out, _mm512_cvtepu8_epi32 (_mm512_castsi512_si128 (v)));
+  if (groups > 1)
+    store (out + 64,
+	   _mm512_cvtepu8_epi32 (_mm512_extracti32x4_epi32 (v, 1)));
+  if (groups > 2)
+    store (out + 128,
+	   _mm512_cvtepu8_epi32 (_mm512_extracti32x4_epi32 (v, 2)));
+  if (groups > 3)
+    store (out + 192,
+	   _mm512_cvtepu8_epi32 (_mm512_extracti32x4_epi32 (v, 3)));
+}
+
+static __always_inline void
+narrow_group (unsigned char *out, vec_t v)
+{
+  _mm_storeu_si128 ((__m128i *) out, _mm512_cvtepi32_epi8 (v));
+}
+
+static __always_inline void
+narrow (unsigned char *out, vec_t v0, vec_t v1, vec_t v2, vec_t v3)
+{
+  narrow_group (out, v0);
+  narrow_group (out + 16, v1);
+  narrow_group (out + 32, v2);
+  narrow_group (out + 48, v3);
+}
+#else
+# error "Unsupported VEC_SIZE"
+#endif
+
+#define GROUP (VEC_SIZE / 4)
+
+static __always_inline size_t
+ascii_to_internal (const unsigned char *in, unsigned char *out)
+{
+  vec_t v = load (in);
+  uint64_t mask = byte_mask (v);
+  if (mask == 0)
+    {
+      widen (out, v, 4);
+      return VEC_SIZE;
+    }
+  unsigned int groups = __builtin_ctzll (mask) / GROUP;
+  widen (out, v, groups);
+  return groups * GROUP;
+}
+
+static __always_inline size_t
+internal_to_ascii (const unsigned char *in, unsigned char *out)
+{
+  vec_t v0 = load (in);
+  vec_t v1 = load (in + VEC_SIZE);
+  vec_t v2 = load (in + 2 * VEC_SIZE);
+  vec_t v3 = load (in + 3 * VEC_SIZE);
+  vec_t any = v0 | v1 | v2 | v3;
+  if (element_mask (any) == 0)
+    {
+      narrow (out, v0, v1, v2, v3);
+      return VEC_SIZE;
+    }
+  if (element_mask (v0) != 0)
+    return 0;
+  narrow_group (out, v0);
+  if (element_mask (v1) != 0)
+    return GROUP;
+  narrow_group (out + GROUP, v1);
+  if (element_mask (v2) != 0)
+    return 2 * GROUP;
+  narrow_group (out + 2 * GROUP, v2);
+  return 3 * GROUP;
+}
+
+#include <iconv/gconv_bulk.h>
+
+#ifdef BULK_UTF8_INTERNAL_RTM
+extern __typeof (BULK_UTF8_INTERNAL) __gconv_bulk_utf8_internal_sse4_1
+  attribute_hidden;
+extern __typeof (BULK_INTERNAL_UTF8) __gconv_bulk_internal_utf8_sse4_1
+  attribute_hidden;
+
+void
+BULK_UTF8_INTERNAL_RTM (const unsigned char **inptrp,
+			const unsigned char *inend,
+			unsigned char **outptrp, const unsigned char *outend)
+{
+  if (_xtest ())
+    __gconv_bulk_utf8_internal_sse4_1 (inptrp, inend, outptrp, outend);
+  else
+    BULK_UTF8_INTERNAL (inptrp, inend, outptrp, outend);
+}
+
+void
+BULK_INTERNAL_UTF8_RTM (const unsigned char **inptrp,
+			const unsigned char *inend,
+			unsigned char **outptrp, const unsigned char *outend)
+{
+  if (_xtest ())
+    __gconv_bulk_internal_utf8_sse4_1 (inptrp, inend, outptrp, outend);
+  else
+    BULK_INTERNAL_UTF8 (inptrp, inend, outptrp, outend);
+}
+#endif
@@ -0,0 +1,63 @@
+/* Common definition for __gconv_bulk_* ifunc selections.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <init-arch.h>
+
+extern __typeof (__gconv_bulk_utf8_internal) OPTIMIZE (sse2) attribute_hidden;
+extern __typeof (__gconv_bulk_utf8_internal) OPTIMIZE (sse4_1)
+  attribute_hidden;
+extern __typeof (__gconv_bulk_utf8_internal) OPTIMIZE (avx2) attribute_hidden;
+extern __typeof (__gconv_bulk_utf8_internal) OPTIMIZE (avx2_rtm)
+  attribute_hidden;
+extern __typeof (__gconv_bulk_utf8_internal) OPTIMIZE (avx512)
+  attribute_hidden;
+extern __typeof (__gconv_bulk_utf8_internal) OPTIMIZE (avx512_rtm)
+  attribute_hidden;
+
+/* The AVX2 and AVX512 versions are written in C, and are replaced by
+   the *_rtm versions on processors with RTM as described in
+   ifunc-vec-c.h.  */
+static inline void *
+IFUNC_SELECTOR (void)
+{
+  const struct cpu_features* cpu_features = __get_cpu_features ();
+
+  if (CPU_FEATURE_USABLE_P (cpu_features, AVX512F)
+      && CPU_FEATURE_USABLE_P (cpu_features, AVX512BW)
+      && !CPU_FEATURES_ARCH_P (cpu_features, Prefer_No_AVX512))
+    {
+      if (CPU_FEATURE_USABLE_P (cpu_features, RTM))
+	return OPTIMIZE (avx512_rtm);
+
+      return OPTIMIZE (avx512);
+    }
+
+  if (CPU_FEATURE_USABLE_P (cpu_features, AVX2))
+    {
+      if (CPU_FEATURE_USABLE_P (cpu_features, RTM))
+	return OPTIMIZE (avx2_rtm);
+
+      if (!CPU_FEATURES_ARCH_P (cpu_features, Prefer_No_VZEROUPPER))
+	return OPTIMIZE (avx2);
+    }
+
+  if (CPU_FEATURE_USABLE_P (cpu_features, SSE4_1))
+    return OPTIMIZE (sse4_1);
+
+  return OPTIMIZE (sse2);
+}
@@ -20,6 +20,7 @@
 #include <string.h>
 #include <wchar.h>
 #include <ifunc-impl-list.h>
+#include <iconv/gconv_int.h>
 #include <sysdep.h>
 #include "init-arch.h"
 
@@ -130,6 +131,26 @@ __libc_ifunc_impl_list (const char *name, struct libc_ifunc_impl *array,
 			      __memmove_chk_erms))
 #endif
 
+  /* Support sysdeps/x86_64/multiarch/memmem.c.  */
+  IFUNC_IMPL (i, name, memmem,
+	      IFUNC_IMPL_ADD (array, i, memmem,
+			      CPU_FEATURE_USABLE (AVX2),
+			      __memmem_avx2)
+	      IFUNC_IMPL_ADD (array, i, memmem,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __memmem_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, memmem,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)),
+			      __memmem_evex)
+	      IFUNC_IMPL_ADD (array, i, memmem,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __memmem_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, memmem, 1, __memmem_sse2))
+
   /* Support sysdeps/x86_64/multiarch/memmove.c.  */
   IFUNC_IMPL (i, name, memmove,
 	      IFUNC_IMPL_ADD (array, i, memmove,
@@ -376,6 +397,24 @@ __libc_ifunc_impl_list (const char *name, struct libc_ifunc_impl *array,
 
   /* Support sysdeps/x86_64/multiarch/strcasecmp_l.c.  */
   IFUNC_IMPL (i, name, strcasecmp,
+	      IFUNC_IMPL_ADD (array, i, strcasecmp,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __strcasecmp_evex)
+	      IFUNC_IMPL_ADD (array, i, strcasecmp,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strcasecmp_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, strcasecmp,
+			      CPU_FEATURE_USABLE (AVX2),
+			      __strcasecmp_avx2)
+	      IFUNC_IMPL_ADD (array, i, strcasecmp,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strcasecmp_avx2_rtm)
 	      IFUNC_IMPL_ADD (array, i, strcasecmp,
 			      CPU_FEATURE_USABLE (AVX),
 			      __strcasecmp_avx)
@@ -389,6 +428,24 @@ __libc_ifunc_impl_list (const char *name, struct libc_ifunc_impl *array,
 
   /* Support sysdeps/x86_64/multiarch/strcasecmp_l.c.  */
   IFUNC_IMPL (i, name, strcasecmp_l,
+	      IFUNC_IMPL_ADD (array, i, strcasecmp_l,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __strcasecmp_l_evex)
+	      IFUNC_IMPL_ADD (array, i, strcasecmp_l,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strcasecmp_l_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, strcasecmp_l,
+			      CPU_FEATURE_USABLE (AVX2),
+			      __strcasecmp_l_avx2)
+	      IFUNC_IMPL_ADD (array, i, strcasecmp_l,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strcasecmp_l_avx2_rtm)
 	      IFUNC_IMPL_ADD (array, i, strcasecmp_l,
 			      CPU_FEATURE_USABLE (AVX),
 			      __strcasecmp_l_avx)
@@ -510,12 +567,47 @@ __libc_ifunc_impl_list (const char *name, struct libc_ifunc_impl *array,
 
   /* Support sysdeps/x86_64/multiarch/strcspn.c.  */
   IFUNC_IMPL (i, name, strcspn,
+	      IFUNC_IMPL_ADD (array, i, strcspn,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __strcspn_evex)
+	      IFUNC_IMPL_ADD (array, i, strcspn,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strcspn_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, strcspn, CPU_FEATURE_USABLE (AVX2),
+			      __strcspn_avx2)
+	      IFUNC_IMPL_ADD (array, i, strcspn,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strcspn_avx2_rtm)
 	      IFUNC_IMPL_ADD (array, i, strcspn, CPU_FEATURE_USABLE (SSE4_2),
 			      __strcspn_sse42)
 	      IFUNC_IMPL_ADD (array, i, strcspn, 1, __strcspn_sse2))
 
   /* Support sysdeps/x86_64/multiarch/strncase_l.c.  */
   IFUNC_IMPL (i, name, strncasecmp,
+	      IFUNC_IMPL_ADD (array, i, strncasecmp,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __strncasecmp_evex)
+	      IFUNC_IMPL_ADD (array, i, strncasecmp,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strncasecmp_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, strncasecmp,
+			      CPU_FEATURE_USABLE (AVX2),
+			      __strncasecmp_avx2)
+	      IFUNC_IMPL_ADD (array, i, strncasecmp,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strncasecmp_avx2_rtm)
 	      IFUNC_IMPL_ADD (array, i, strncasecmp,
 			      CPU_FEATURE_USABLE (AVX),
 			      __strncasecmp_avx)
@@ -530,6 +622,24 @@ __libc_ifunc_impl_list (const char *name, struct libc_ifunc_impl *array,
 
   /* Support sysdeps/x86_64/multiarch/strncase_l.c.  */
   IFUNC_IMPL (i, name, strncasecmp_l,
+	      IFUNC_IMPL_ADD (array, i, strncasecmp_l,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __strncasecmp_l_evex)
+	      IFUNC_IMPL_ADD (array, i, strncasecmp_l,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strncasecmp_l_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, strncasecmp_l,
+			      CPU_FEATURE_USABLE (AVX2),
+			      __strncasecmp_l_avx2)
+	      IFUNC_IMPL_ADD (array, i, strncasecmp_l,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strncasecmp_l_avx2_rtm)
 	      IFUNC_IMPL_ADD (array, i, strncasecmp_l,
 			      CPU_FEATURE_USABLE (AVX),
 			      __strncasecmp_l_avx)
@@ -580,6 +690,23 @@ __libc_ifunc_impl_list (const char *name, struct libc_ifunc_impl *array,
 
   /* Support sysdeps/x86_64/multiarch/strpbrk.c.  */
   IFUNC_IMPL (i, name, strpbrk,
+	      IFUNC_IMPL_ADD (array, i, strpbrk,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __strpbrk_evex)
+	      IFUNC_IMPL_ADD (array, i, strpbrk,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strpbrk_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, strpbrk, CPU_FEATURE_USABLE (AVX2),
+			      __strpbrk_avx2)
+	      IFUNC_IMPL_ADD (array, i, strpbrk,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strpbrk_avx2_rtm)
 	      IFUNC_IMPL_ADD (array, i, strpbrk, CPU_FEATURE_USABLE (SSE4_2),
 			      __strpbrk_sse42)
 	      IFUNC_IMPL_ADD (array, i, strpbrk, 1, __strpbrk_sse2))
@@ -587,12 +714,45 @@ __libc_ifunc_impl_list (const char *name, struct libc_ifunc_impl *array,
 
   /* Support sysdeps/x86_64/multiarch/strspn.c.  */
   IFUNC_IMPL (i, name, strspn,
+	      IFUNC_IMPL_ADD (array, i, strspn,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __strspn_evex)
+	      IFUNC_IMPL_ADD (array, i, strspn,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strspn_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, strspn, CPU_FEATURE_USABLE (AVX2),
+			      __strspn_avx2)
+	      IFUNC_IMPL_ADD (array, i, strspn,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strspn_avx2_rtm)
 	      IFUNC_IMPL_ADD (array, i, strspn, CPU_FEATURE_USABLE (SSE4_2),
 			      __strspn_sse42)
 	      IFUNC_IMPL_ADD (array, i, strspn, 1, __strspn_sse2))
 
   /* Support sysdeps/x86_64/multiarch/strstr.c.  */
   IFUNC_IMPL (i, name, strstr,
+	      IFUNC_IMPL_ADD (array, i, strstr,
+			      CPU_FEATURE_USABLE (AVX2),
+			      __strstr_avx2)
+	      IFUNC_IMPL_ADD (array, i, strstr,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strstr_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, strstr,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)),
+			      __strstr_evex)
+	      IFUNC_IMPL_ADD (array, i, strstr,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __strstr_evex_rtm)
 	      IFUNC_IMPL_ADD (array, i, strstr, 1, __strstr_sse2_unaligned)
 	      IFUNC_IMPL_ADD (array, i, strstr, 1, __strstr_sse2))
 
@@ -664,10 +824,162 @@ __libc_ifunc_impl_list (const char *name, struct libc_ifunc_impl *array,
 
   /* Support sysdeps/x86_64/multiarch/wcscpy.c.  */
   IFUNC_IMPL (i, name, wcscpy,
+	      IFUNC_IMPL_ADD (array, i, wcscpy,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __wcscpy_evex)
+	      IFUNC_IMPL_ADD (array, i, wcscpy,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcscpy_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcscpy, CPU_FEATURE_USABLE (AVX2),
+			      __wcscpy_avx2)
+	      IFUNC_IMPL_ADD (array, i, wcscpy,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcscpy_avx2_rtm)
 	      IFUNC_IMPL_ADD (array, i, wcscpy, CPU_FEATURE_USABLE (SSSE3),
 			      __wcscpy_ssse3)
 	      IFUNC_IMPL_ADD (array, i, wcscpy, 1, __wcscpy_sse2))
 
+  /* Support sysdeps/x86_64/multiarch/wcpcpy.c.  */
+  IFUNC_IMPL (i, name, wcpcpy,
+	      IFUNC_IMPL_ADD (array, i, wcpcpy,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __wcpcpy_evex)
+	      IFUNC_IMPL_ADD (array, i, wcpcpy,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcpcpy_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcpcpy, CPU_FEATURE_USABLE (AVX2),
+			      __wcpcpy_avx2)
+	      IFUNC_IMPL_ADD (array, i, wcpcpy,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcpcpy_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcpcpy, 1, __wcpcpy_sse2))
+
+  /* Support sysdeps/x86_64/multiarch/wcscat.c.  */
+  IFUNC_IMPL (i, name, wcscat,
+	      IFUNC_IMPL_ADD (array, i, wcscat,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __wcscat_evex)
+	      IFUNC_IMPL_ADD (array, i, wcscat,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcscat_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcscat, CPU_FEATURE_USABLE (AVX2),
+			      __wcscat_avx2)
+	      IFUNC_IMPL_ADD (array, i, wcscat,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcscat_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcscat, 1, __wcscat_sse2))
+
+  /* Support sysdeps/x86_64/multiarch/wcsncpy.c.  */
+  IFUNC_IMPL (i, name, wcsncpy,
+	      IFUNC_IMPL_ADD (array, i, wcsncpy,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __wcsncpy_evex)
+	      IFUNC_IMPL_ADD (array, i, wcsncpy,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcsncpy_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcsncpy, CPU_FEATURE_USABLE (AVX2),
+			      __wcsncpy_avx2)
+	      IFUNC_IMPL_ADD (array, i, wcsncpy,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcsncpy_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcsncpy, 1, __wcsncpy_sse2))
+
+  /* Support sysdeps/x86_64/multiarch/wcpncpy.c.  */
+  IFUNC_IMPL (i, name, wcpncpy,
+	      IFUNC_IMPL_ADD (array, i, wcpncpy,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __wcpncpy_evex)
+	      IFUNC_IMPL_ADD (array, i, wcpncpy,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcpncpy_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcpncpy, CPU_FEATURE_USABLE (AVX2),
+			      __wcpncpy_avx2)
+	      IFUNC_IMPL_ADD (array, i, wcpncpy,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcpncpy_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcpncpy, 1, __wcpncpy_sse2))
+
+  /* Support sysdeps/x86_64/multiarch/wcsncat.c.  */
+  IFUNC_IMPL (i, name, wcsncat,
+	      IFUNC_IMPL_ADD (array, i, wcsncat,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)),
+			      __wcsncat_evex)
+	      IFUNC_IMPL_ADD (array, i, wcsncat,
+			      (CPU_FEATURE_USABLE (AVX512VL)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcsncat_evex_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcsncat, CPU_FEATURE_USABLE (AVX2),
+			      __wcsncat_avx2)
+	      IFUNC_IMPL_ADD (array, i, wcsncat,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcsncat_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcsncat, 1, __wcsncat_sse2))
+
+  /* Support sysdeps/x86_64/multiarch/wcsspn.c.  */
+  IFUNC_IMPL (i, name, wcsspn,
+	      IFUNC_IMPL_ADD (array, i, wcsspn, CPU_FEATURE_USABLE (AVX2),
+			      __wcsspn_avx2)
+	      IFUNC_IMPL_ADD (array, i, wcsspn,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcsspn_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcsspn, 1, __wcsspn_sse2))
+
+  /* Support sysdeps/x86_64/multiarch/wcscspn.c.  */
+  IFUNC_IMPL (i, name, wcscspn,
+	      IFUNC_IMPL_ADD (array, i, wcscspn, CPU_FEATURE_USABLE (AVX2),
+			      __wcscspn_avx2)
+	      IFUNC_IMPL_ADD (array, i, wcscspn,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcscspn_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcscspn, 1, __wcscspn_sse2))
+
+  /* Support sysdeps/x86_64/multiarch/wcspbrk.c.  */
+  IFUNC_IMPL (i, name, wcspbrk,
+	      IFUNC_IMPL_ADD (array, i, wcspbrk, CPU_FEATURE_USABLE (AVX2),
+			      __wcspbrk_avx2)
+	      IFUNC_IMPL_ADD (array, i, wcspbrk,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __wcspbrk_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, wcspbrk, 1, __wcspbrk_sse2))
+
   /* Support sysdeps/x86_64/multiarch/wcslen.c.  */
   IFUNC_IMPL (i, name, wcslen,
 	      IFUNC_IMPL_ADD (array, i, wcslen,
@@ -990,5 +1302,53 @@ __libc_ifunc_impl_list (const char *name, struct libc_ifunc_impl *array,
 			      __wmemset_chk_avx512_unaligned))
 #endif
 
+  /* Support sysdeps/x86_64/multiarch/gconv_bulk.c.  */
+  IFUNC_IMPL (i, name, __gconv_bulk_utf8_internal,
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_utf8_internal,
+			      (CPU_FEATURE_USABLE (AVX512F)
+			       && CPU_FEATURE_USABLE (AVX512BW)),
+			      __gconv_bulk_utf8_internal_avx512)
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_utf8_internal,
+			      (CPU_FEATURE_USABLE (AVX512F)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __gconv_bulk_utf8_internal_avx512_rtm)
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_utf8_internal,
+			      CPU_FEATURE_USABLE (AVX2),
+			      __gconv_bulk_utf8_internal_avx2)
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_utf8_internal,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __gconv_bulk_utf8_internal_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_utf8_internal,
+			      CPU_FEATURE_USABLE (SSE4_1),
+			      __gconv_bulk_utf8_internal_sse4_1)
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_utf8_internal, 1,
+			      __gconv_bulk_utf8_internal_sse2))
+
+  /* Support sysdeps/x86_64/multiarch/gconv_bulk.c.  */
+  IFUNC_IMPL (i, name, __gconv_bulk_internal_utf8,
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_internal_utf8,
+			      (CPU_FEATURE_USABLE (AVX512F)
+			       && CPU_FEATURE_USABLE (AVX512BW)),
+			      __gconv_bulk_internal_utf8_avx512)
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_internal_utf8,
+			      (CPU_FEATURE_USABLE (AVX512F)
+			       && CPU_FEATURE_USABLE (AVX512BW)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __gconv_bulk_internal_utf8_avx512_rtm)
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_internal_utf8,
+			      CPU_FEATURE_USABLE (AVX2),
+			      __gconv_bulk_internal_utf8_avx2)
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_internal_utf8,
+			      (CPU_FEATURE_USABLE (AVX2)
+			       && CPU_FEATURE_USABLE (RTM)),
+			      __gconv_bulk_internal_utf8_avx2_rtm)
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_internal_utf8,
+			      CPU_FEATURE_USABLE (SSE4_1),
+			      __gconv_bulk_internal_utf8_sse4_1)
+	      IFUNC_IMPL_ADD (array, i, __gconv_bulk_internal_utf8, 1,
+			      __gconv_bulk_internal_utf8_sse2))
+
   return i;
 }
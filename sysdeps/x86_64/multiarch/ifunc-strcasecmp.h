@@ -25,10 +25,8 @@ extern __typeof (REDIRECT_NAME) OPTIMIZE (sse42) attribute_hidden;
 extern __typeof (REDIRECT_NAME) OPTIMIZE (avx) attribute_hidden;
 
 static inline void *
-IFUNC_SELECTOR (void)
+select_strcasecmp_fallback (const struct cpu_features *cpu_features)
 {
-  const struct cpu_features* cpu_features = __get_cpu_features ();
-
   if (CPU_FEATURE_USABLE_P (cpu_features, AVX))
     return OPTIMIZE (avx);
 
@@ -41,3 +39,6 @@ IFUNC_SELECTOR (void)
 
   return OPTIMIZE (sse2);
 }
+
+#define IFUNC_VEC_C_FALLBACK select_strcasecmp_fallback (cpu_features)
+#include "ifunc-vec-c.h"
@@ -1,4 +1,4 @@
-/* Common definition for ifunc selections optimized with SSE2 and SSE4.2.
+/* Common definition for strcspn, strpbrk and strspn ifunc selections.
    All versions must be listed in ifunc-impl-list.c.
    Copyright (C) 2017-2021 Free Software Foundation, Inc.
    This file is part of the GNU C Library.
@@ -19,16 +19,9 @@
 
 #include <init-arch.h>
 
-extern __typeof (REDIRECT_NAME) OPTIMIZE (sse2) attribute_hidden;
 extern __typeof (REDIRECT_NAME) OPTIMIZE (sse42) attribute_hidden;
 
-static inline void *
-IFUNC_SELECTOR (void)
-{
-  const struct cpu_features* cpu_features = __get_cpu_features ();
-
-  if (CPU_FEATURE_USABLE_P (cpu_features, SSE4_2))
-    return OPTIMIZE (sse42);
-
-  return OPTIMIZE (sse2);
-}
+#define IFUNC_VEC_C_FALLBACK						\
+  (CPU_FEATURE_USABLE_P (cpu_features, SSE4_2)				\
+   ? OPTIMIZE (sse42) : OPTIMIZE (sse2))
+#include "ifunc-vec-c.h"
@@ -0,0 +1,73 @@
+/* Common definition for ifunc selections of functions written in C
+   with AVX2 and EVEX intrinsics.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* In the AVX2 and EVEX versions written in C, the compiler decides
+   where to place VZEROUPPER, also before calls to other functions, and
+   VZEROUPPER aborts RTM transactions.  On processors with RTM, the
+   *_avx2_rtm and *_evex_rtm versions are selected instead.  They check
+   with XTEST whether they are called inside a transaction and use the
+   SSE2 version if they are, and the AVX2 or EVEX version otherwise.
+
+   IFUNC_VEC_C_FALLBACK, if defined, is the selection for processors
+   where neither is used.  It may use cpu_features and defaults to the
+   SSE2 version.  IFUNC_VEC_C_NO_EVEX is defined for functions without
+   EVEX versions.  */
+
+#include <init-arch.h>
+
+extern __typeof (REDIRECT_NAME) OPTIMIZE (sse2) attribute_hidden;
+extern __typeof (REDIRECT_NAME) OPTIMIZE (avx2) attribute_hidden;
+extern __typeof (REDIRECT_NAME) OPTIMIZE (avx2_rtm) attribute_hidden;
+#ifndef IFUNC_VEC_C_NO_EVEX
+extern __typeof (REDIRECT_NAME) OPTIMIZE (evex) attribute_hidden;
+extern __typeof (REDIRECT_NAME) OPTIMIZE (evex_rtm) attribute_hidden;
+#endif
+
+#ifndef IFUNC_VEC_C_FALLBACK
+# define IFUNC_VEC_C_FALLBACK OPTIMIZE (sse2)
+#endif
+
+static inline void *
+IFUNC_SELECTOR (void)
+{
+  const struct cpu_features* cpu_features = __get_cpu_features ();
+
+  if (CPU_FEATURE_USABLE_P (cpu_features, AVX2)
+      && CPU_FEATURES_ARCH_P (cpu_features, AVX_Fast_Unaligned_Load))
+    {
+#ifndef IFUNC_VEC_C_NO_EVEX
+      if (CPU_FEATURE_USABLE_P (cpu_features, AVX512VL)
+	  && CPU_FEATURE_USABLE_P (cpu_features, AVX512BW))
+	{
+	  if (CPU_FEATURE_USABLE_P (cpu_features, RTM))
+	    return OPTIMIZE (evex_rtm);
+
+	  return OPTIMIZE (evex);
+	}
+#endif
+
+      if (CPU_FEATURE_USABLE_P (cpu_features, RTM))
+	return OPTIMIZE (avx2_rtm);
+
+      if (!CPU_FEATURES_ARCH_P (cpu_features, Prefer_No_VZEROUPPER))
+	return OPTIMIZE (avx2);
+    }
+
+  return IFUNC_VEC_C_FALLBACK;
+}
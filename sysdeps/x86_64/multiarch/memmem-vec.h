@@ -0,0 +1,95 @@
+/* memmem with a vectorized first and last byte filter.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The haystack is searched VEC_SIZE candidate positions at a time.
+   The bytes at the candidate positions are compared with the first
+   byte of the needle and the bytes NE_LEN - 1 positions later with
+   the last byte of the needle, and only the positions where both
+   match are compared with the whole needle.  Long needles, short
+   haystacks and haystacks with too many such candidates are handed to
+   __memmem_sse2, which uses the Two-Way algorithm for long needles.
+
+   MEMMEM must be defined to the name of the function.  MEMMEM_RTM, if
+   defined, is the name of the version for processors with RTM.  */
+
+#include <string.h>
+#include "vec-search.h"
+
+extern __typeof (memmem) __memmem_sse2 attribute_hidden;
+
+void *
+MEMMEM (const void *haystack, size_t hs_len,
+	const void *needle, size_t ne_len)
+{
+  const unsigned char *hs = (const unsigned char *) haystack;
+  const unsigned char *ne = (const unsigned char *) needle;
+
+  if (ne_len == 0)
+    return (void *) hs;
+  if (ne_len == 1)
+    return (void *) memchr (hs, ne[0], hs_len);
+  if (hs_len < ne_len)
+    return NULL;
+
+  /* END is one past the last position at which the needle may start.  */
+  const unsigned char *end = hs + hs_len - ne_len + 1;
+  if (ne_len > VEC_SEARCH_MAX_NEEDLE || end - hs < VEC_SIZE)
+    return __memmem_sse2 (haystack, hs_len, needle, ne_len);
+
+  vec_t first = vec_set1 (ne[0]);
+  vec_t last = vec_set1 (ne[ne_len - 1]);
+  size_t nverify = 0;
+  const unsigned char *p = hs;
+  while (true)
+    {
+      /* The last block overlaps the previous one, so the candidates are
+	 checked without reading past the end of the haystack.  */
+      bool final = p >= end - VEC_SIZE;
+      if (final)
+	p = end - VEC_SIZE;
+
+      uint32_t m = vec_eq2 (vec_loadu (p), first,
+			    vec_loadu (p + ne_len - 1), last);
+      while (m != 0)
+	{
+	  const unsigned char *cand = p + __builtin_ctz (m);
+	  if (memcmp (cand + 1, ne + 1, ne_len - 2) == 0)
+	    return (void *) cand;
+	  ++nverify;
+	  m &= m - 1;
+	}
+
+      if (final)
+	return NULL;
+      p += VEC_SIZE;
+
+      if (__glibc_unlikely (vec_search_too_slow (nverify, ne_len, p - hs)))
+	return __memmem_sse2 (p, hs_len - (p - hs), needle, ne_len);
+    }
+}
+
+#ifdef MEMMEM_RTM
+void *
+MEMMEM_RTM (const void *haystack, size_t hs_len,
+	    const void *needle, size_t ne_len)
+{
+  if (_xtest ())
+    return __memmem_sse2 (haystack, hs_len, needle, ne_len);
+  return MEMMEM (haystack, hs_len, needle, ne_len);
+}
+#endif
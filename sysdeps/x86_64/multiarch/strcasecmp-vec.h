@@ -0,0 +1,209 @@
+/* strcasecmp and strncasecmp with AVX2 or EVEX intrinsics.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <immintrin.h>
+#include <locale/localeinfo.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* In locales whose single-byte case mapping is that of ASCII, only
+   'A' to 'Z' change when converted to lower case.  32 bytes of both
+   strings are converted with a range check and an add, and compared.
+   Other locales use the C implementation, which looks up each byte in
+   the locale's tolower table.
+
+   Both strings are read with unaligned loads.  A load which could
+   cross into the next page is replaced by a comparison byte by byte
+   until the string is past the page boundary.
+
+   STRCASECMP and STRCASECMP_L must be defined to the names of the
+   functions.  STRCASECMP_RTM and STRCASECMP_L_RTM, if defined, are the
+   names of the versions for processors with RTM.  */
+
+#define VEC_SIZE 32
+#ifndef PAGE_SIZE
+# define PAGE_SIZE 4096
+#endif
+
+typedef __m256i vec_t;
+
+#ifdef USE_AS_STRNCASECMP_L
+# define LENGTH_PARAM , size_t n
+# define LENGTH_ARG , n
+extern int __strncasecmp_l_nonascii (const char *, const char *, size_t,
+				     locale_t) attribute_hidden;
+# define NONASCII __strncasecmp_l_nonascii
+#else
+# define LENGTH_PARAM
+# define LENGTH_ARG
+extern int __strcasecmp_l_nonascii (const char *, const char *, locale_t)
+  attribute_hidden;
+# define NONASCII __strcasecmp_l_nonascii
+#endif
+
+static __always_inline int
+tolower_ascii (unsigned char c)
+{
+  return c - 'A' < 26u ? c + ('a' - 'A') : c;
+}
+
+static __always_inline vec_t
+vec_tolower (vec_t v)
+{
+#ifdef USE_EVEX
+  vec_t shifted = _mm256_sub_epi8 (v, _mm256_set1_epi8 ('A'));
+  __mmask32 upper = _mm256_cmplt_epu8_mask (shifted, _mm256_set1_epi8 (26));
+  return _mm256_mask_add_epi8 (v, upper, v, _mm256_set1_epi8 ('a' - 'A'));
+#else
+  /* Move 'A' to -128, so that the upper-case letters are the smallest
+     signed values.  */
+  vec_t shifted = _mm256_add_epi8 (v, _mm256_set1_epi8 (0x80 - 'A'));
+  vec_t upper = _mm256_cmpgt_epi8 (_mm256_set1_epi8 (-128 + 26), shifted);
+  return _mm256_add_epi8 (v, _mm256_and_si256 (upper,
+					       _mm256_set1_epi8 ('a' - 'A')));
+#endif
+}
+
+/* Return a mask with bit I set if byte I of A and B differ after
+   conversion to lower case, or if byte I of A is null.  */
+static __always_inline uint32_t
+vec_stop (vec_t a, vec_t b)
+{
+  vec_t la = vec_tolower (a);
+  vec_t lb = vec_tolower (b);
+#ifdef USE_EVEX
+  return _mm256_mask_cmpeq_epi8_mask (_mm256_test_epi8_mask (a, a), la, lb)
+	 ^ 0xffffffffu;
+#else
+  vec_t zero = _mm256_cmpeq_epi8 (a, _mm256_setzero_si256 ());
+  return ~_mm256_movemask_epi8 (_mm256_cmpeq_epi8 (la, lb))
+	 | _mm256_movemask_epi8 (zero);
+#endif
+}
+
+static __always_inline bool
+may_cross_page (const unsigned char *p)
+{
+  return ((uintptr_t) p & (PAGE_SIZE - 1)) > PAGE_SIZE - VEC_SIZE;
+}
+
+static int
+compare_ascii (const unsigned char *p1, const unsigned char *p2 LENGTH_PARAM)
+{
+#ifndef USE_AS_STRNCASECMP_L
+  const size_t n = SIZE_MAX;
+#endif
+#ifdef USE_AS_STRNCASECMP_L
+  if (n == 0)
+    return 0;
+#endif
+
+  /* Lookups in tables of names mostly fail at the first byte, which is
+     cheaper to check without setting up the vector constants.  */
+  int result = tolower_ascii (p1[0]) - tolower_ascii (p2[0]);
+  if (result != 0 || p1[0] == '\0')
+    return result;
+
+  size_t i = 0;
+
+  while (i < n)
+    {
+      if (__glibc_unlikely (may_cross_page (p1 + i)
+			    || may_cross_page (p2 + i)))
+	{
+	  /* Compare up to VEC_SIZE bytes one at a time.  This moves at
+	     least one string past the page boundary.  */
+	  size_t end = n - i > VEC_SIZE ? i + VEC_SIZE : n;
+	  for (; i < end; ++i)
+	    {
+	      int result = tolower_ascii (p1[i]) - tolower_ascii (p2[i]);
+	      if (result != 0 || p1[i] == '\0')
+		return result;
+	    }
+	  continue;
+	}
+
+      uint32_t stop = vec_stop (_mm256_loadu_si256 ((const vec_t *) (p1 + i)),
+				_mm256_loadu_si256 ((const vec_t *) (p2 + i)));
+#ifdef USE_AS_STRNCASECMP_L
+      if (n - i < VEC_SIZE)
+	stop &= (1u << (n - i)) - 1;
+#endif
+      if (stop != 0)
+	{
+	  i += __builtin_ctz (stop);
+	  return tolower_ascii (p1[i]) - tolower_ascii (p2[i]);
+	}
+      i += VEC_SIZE;
+    }
+
+  return 0;
+}
+
+static __always_inline int
+compare (const char *s1, const char *s2 LENGTH_PARAM, locale_t loc)
+{
+  const struct __locale_data *ctype = loc->__locales[LC_CTYPE];
+  if (ctype->values[_NL_ITEM_INDEX (_NL_CTYPE_NONASCII_CASE)].word != 0)
+    return NONASCII (s1, s2 LENGTH_ARG, loc);
+
+  return compare_ascii ((const unsigned char *) s1,
+			(const unsigned char *) s2 LENGTH_ARG);
+}
+
+int
+STRCASECMP_L (const char *s1, const char *s2 LENGTH_PARAM, locale_t loc)
+{
+  return compare (s1, s2 LENGTH_ARG, loc);
+}
+
+int
+STRCASECMP (const char *s1, const char *s2 LENGTH_PARAM)
+{
+  return compare (s1, s2 LENGTH_ARG, _NL_CURRENT_LOCALE);
+}
+
+#ifdef STRCASECMP_RTM
+# ifdef USE_AS_STRNCASECMP_L
+#  define STRCASECMP_SSE2 __strncasecmp_sse2
+#  define STRCASECMP_L_SSE2 __strncasecmp_l_sse2
+# else
+#  define STRCASECMP_SSE2 __strcasecmp_sse2
+#  define STRCASECMP_L_SSE2 __strcasecmp_l_sse2
+# endif
+
+extern __typeof (STRCASECMP) STRCASECMP_SSE2 attribute_hidden;
+extern __typeof (STRCASECMP_L) STRCASECMP_L_SSE2 attribute_hidden;
+
+int
+STRCASECMP_L_RTM (const char *s1, const char *s2 LENGTH_PARAM, locale_t loc)
+{
+  if (_xtest ())
+    return STRCASECMP_L_SSE2 (s1, s2 LENGTH_ARG, loc);
+  return STRCASECMP_L (s1, s2 LENGTH_ARG, loc);
+}
+
+int
+STRCASECMP_RTM (const char *s1, const char *s2 LENGTH_PARAM)
+{
+  if (_xtest ())
+    return STRCASECMP_SSE2 (s1, s2 LENGTH_ARG);
+  return STRCASECMP (s1, s2 LENGTH_ARG);
+}
+#endif
@@ -0,0 +1,161 @@
+/* strcspn, strpbrk and strspn with AVX2 or EVEX intrinsics.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <immintrin.h>
+#include <libc-pointer-arith.h>
+#include <stdint.h>
+#include <string.h>
+
+/* The set of characters is stored as a 256-bit bitmap split by the
+   low nibble of the character: bit (C >> 4) & 7 of TABLE[C >> 7][C & 15]
+   is set if C is in the set.  A vector of 32 characters is classified
+   with three byte shuffles:
+
+     row = pshufb (table[0], c) | pshufb (table[1], c ^ 0x80)
+     bit = pshufb (bits, c >> 4)
+     in set = (row & bit) != 0
+
+   pshufb yields zero for indices with the high bit set, so each
+   character picks its row from exactly one of the two tables, and BITS
+   maps the high nibble to the bit within the row.  Unlike pcmpistri
+   this works for sets of any size, and the cost per character does not
+   depend on the size of the set.
+
+   strcspn and strpbrk add the null byte to the set, so the search for
+   the first character in the set stops at the end of the string as
+   well.  strspn searches for the first character not in the set, which
+   includes the null byte.
+
+   STRCSPN must be defined to the name of the function.  STRCSPN_RTM, if
+   defined, is the name of the version for processors with RTM.  */
+
+#define VEC_SIZE 32
+
+typedef __m256i vec_t;
+
+#ifdef USE_AS_STRPBRK
+# define RETURN(val1, val2) return val1
+#else
+# define RETURN(val1, val2) return val2
+#endif
+
+/* Return a mask with bit I set if byte I of V is in the set described
+   by TABLE0, TABLE1 and BITS.  */
+static __always_inline uint32_t
+in_set (vec_t v, vec_t table0, vec_t table1, vec_t bits)
+{
+  vec_t flipped = _mm256_xor_si256 (v, _mm256_set1_epi8 ((char) 0x80));
+  vec_t row = _mm256_or_si256 (_mm256_shuffle_epi8 (table0, v),
+			       _mm256_shuffle_epi8 (table1, flipped));
+  vec_t high = _mm256_and_si256 (_mm256_srli_epi16 (v, 4),
+				 _mm256_set1_epi8 (0x0f));
+  vec_t bit = _mm256_shuffle_epi8 (bits, high);
+#ifdef USE_EVEX
+  return _mm256_test_epi8_mask (row, bit);
+#else
+  vec_t zero = _mm256_cmpeq_epi8 (_mm256_and_si256 (row, bit),
+				  _mm256_setzero_si256 ());
+  return ~_mm256_movemask_epi8 (zero);
+#endif
+}
+
+#ifdef USE_AS_STRSPN
+# define STOP(v) (~in_set (v, table0, table1, bits))
+#else
+# define STOP(v) in_set (v, table0, table1, bits)
+#endif
+
+#ifdef USE_AS_STRPBRK
+char *
+#else
+size_t
+#endif
+STRCSPN (const char *s, const char *set)
+{
+#ifdef USE_AS_STRSPN
+  if (set[0] == '\0')
+    return 0;
+#else
+  if (set[0] == '\0' || set[1] == '\0')
+    {
+      const char *p = __strchrnul (s, set[0]);
+      RETURN (*p != '\0' ? (char *) p : NULL, p - s);
+    }
+#endif
+
+  uint8_t table[2][16] __attribute__ ((aligned (16))) = { { 0 } };
+  for (const unsigned char *a = (const unsigned char *) set; *a != '\0'; ++a)
+    table[*a >> 7][*a & 15] |= 1 << ((*a >> 4) & 7);
+#ifndef USE_AS_STRSPN
+  table[0][0] |= 1;
+#endif
+
+  /* pshufb looks up each 128-bit lane separately, so the tables are
+     repeated in both lanes.  */
+  const __m128i *t = (const __m128i *) table;
+  vec_t table0 = _mm256_broadcastsi128_si256 (_mm_load_si128 (t));
+  vec_t table1 = _mm256_broadcastsi128_si256 (_mm_load_si128 (t + 1));
+  vec_t bits = _mm256_setr_epi8 (1, 2, 4, 8, 16, 32, 64, -128,
+				 1, 2, 4, 8, 16, 32, 64, -128,
+				 1, 2, 4, 8, 16, 32, 64, -128,
+				 1, 2, 4, 8, 16, 32, 64, -128);
+
+  /* Aligned loads cannot cross into an unmapped page.  The bytes
+     before S in the first block are shifted out of the mask.  */
+  const char *p = PTR_ALIGN_DOWN (s, VEC_SIZE);
+  uint32_t stop = STOP (_mm256_load_si256 ((const vec_t *) p)) >> (s - p);
+  if (stop != 0)
+    p = s + __builtin_ctz (stop);
+  else
+    while (1)
+      {
+	p += VEC_SIZE;
+	stop = STOP (_mm256_load_si256 ((const vec_t *) p));
+	if (stop != 0)
+	  {
+	    p += __builtin_ctz (stop);
+	    break;
+	  }
+      }
+
+  RETURN (*p != '\0' ? (char *) p : NULL, p - s);
+}
+
+#ifdef STRCSPN_RTM
+# if defined USE_AS_STRPBRK
+#  define STRCSPN_SSE2 __strpbrk_sse2
+# elif defined USE_AS_STRSPN
+#  define STRCSPN_SSE2 __strspn_sse2
+# else
+#  define STRCSPN_SSE2 __strcspn_sse2
+# endif
+
+extern __typeof (STRCSPN) STRCSPN_SSE2 attribute_hidden;
+
+# ifdef USE_AS_STRPBRK
+char *
+# else
+size_t
+# endif
+STRCSPN_RTM (const char *s, const char *set)
+{
+  if (_xtest ())
+    return STRCSPN_SSE2 (s, set);
+  return STRCSPN (s, set);
+}
+#endif
@@ -24,7 +24,7 @@
 # undef strcspn
 
 # define SYMBOL_NAME strcspn
-# include "ifunc-sse4_2.h"
+# include "ifunc-strcspn.h"
 
 libc_ifunc_redirected (__redirect_strcspn, strcspn, IFUNC_SELECTOR ());
 
@@ -0,0 +1,25 @@
+/* strncasecmp_l optimized with 256-bit EVEX instructions.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#define USE_EVEX 1
+#define USE_AS_STRNCASECMP_L 1
+#define STRCASECMP __strncasecmp_evex
+#define STRCASECMP_RTM __strncasecmp_evex_rtm
+#define STRCASECMP_L __strncasecmp_l_evex
+#define STRCASECMP_L_RTM __strncasecmp_l_evex_rtm
+#include "strcasecmp-vec.h"
@@ -0,0 +1,115 @@
+/* strstr with a vectorized first and last byte filter.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The haystack is read in aligned blocks of VEC_SIZE bytes, which are
+   compared with the last byte of the needle.  The bytes NE_LEN - 1
+   positions earlier, which are candidates for the start of a match,
+   are compared with the first byte of the needle.  They precede the
+   block and have been checked for the terminating null byte already,
+   so none of the loads can cross into an unmapped page.  Only the
+   positions where both bytes match are compared with the whole
+   needle.  Long needles and haystacks with too many such candidates
+   are handed to __strstr_sse2, which uses the Two-Way algorithm.
+
+   STRSTR must be defined to the name of the function.  STRSTR_RTM, if
+   defined, is the name of the version for processors with RTM.  */
+
+#include <libc-pointer-arith.h>
+#include <string.h>
+#include "vec-search.h"
+
+extern __typeof (strstr) __strstr_sse2 attribute_hidden;
+
+char *
+STRSTR (const char *haystack, const char *needle)
+{
+  const unsigned char *hs = (const unsigned char *) haystack;
+  const unsigned char *ne = (const unsigned char *) needle;
+
+  if (ne[0] == '\0')
+    return (char *) hs;
+  if (ne[1] == '\0')
+    return strchr (haystack, ne[0]);
+
+  size_t ne_len = __strnlen (needle, VEC_SEARCH_MAX_NEEDLE + 1);
+  if (ne_len > VEC_SEARCH_MAX_NEEDLE)
+    return __strstr_sse2 (haystack, needle);
+
+  /* A match ends at HS + NE_LEN - 1 or later.  The bytes before it
+     must not contain the terminator.  */
+  size_t ne_last = ne_len - 1;
+  if (__strnlen (haystack, ne_last) < ne_last)
+    return NULL;
+
+  vec_t first = vec_set1 (ne[0]);
+  vec_t last = vec_set1 (ne[ne_last]);
+
+  /* The first block may start before the end of the first possible
+     match, and its candidates may start before the haystack, so only
+     the last byte is compared with a vector there.  */
+  const unsigned char *b = PTR_ALIGN_DOWN (hs + ne_last, VEC_SIZE);
+  vec_t v = vec_load (b);
+  uint32_t valid = UINT32_MAX << (hs + ne_last - b);
+  uint32_t zero = vec_zero (v) & valid;
+  uint32_t m = vec_eq (v, last) & valid;
+  if (zero != 0)
+    m &= (zero & -zero) - 1;
+  while (m != 0)
+    {
+      const unsigned char *cand = b + __builtin_ctz (m) - ne_last;
+      if (cand[0] == ne[0] && memcmp (cand + 1, ne + 1, ne_last - 1) == 0)
+	return (char *) cand;
+      m &= m - 1;
+    }
+  if (zero != 0)
+    return NULL;
+
+  size_t nverify = 0;
+  while (true)
+    {
+      b += VEC_SIZE;
+      v = vec_load (b);
+      zero = vec_zero (v);
+      m = vec_eq2 (v, last, vec_loadu (b - ne_last), first);
+      if (zero != 0)
+	m &= (zero & -zero) - 1;
+      while (m != 0)
+	{
+	  const unsigned char *cand = b + __builtin_ctz (m) - ne_last;
+	  if (memcmp (cand + 1, ne + 1, ne_last - 1) == 0)
+	    return (char *) cand;
+	  ++nverify;
+	  m &= m - 1;
+	}
+      if (zero != 0)
+	return NULL;
+
+      if (__glibc_unlikely (vec_search_too_slow (nverify, ne_len, b - hs)))
+	return __strstr_sse2 ((const char *) b + VEC_SIZE - ne_last, needle);
+    }
+}
+
+#ifdef STRSTR_RTM
+char *
+STRSTR_RTM (const char *haystack, const char *needle)
+{
+  if (_xtest ())
+    return __strstr_sse2 (haystack, needle);
+  return STRSTR (haystack, needle);
+}
+#endif
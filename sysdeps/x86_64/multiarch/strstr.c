@@ -33,18 +33,20 @@
 
 #include "string/strstr.c"
 
-extern __typeof (__redirect_strstr) __strstr_sse2_unaligned attribute_hidden;
-extern __typeof (__redirect_strstr) __strstr_sse2 attribute_hidden;
+#define SYMBOL_NAME strstr
+#include <init-arch.h>
 
-#include "init-arch.h"
+extern __typeof (REDIRECT_NAME) OPTIMIZE (sse2_unaligned) attribute_hidden;
+
+#define IFUNC_VEC_C_FALLBACK						\
+  (CPU_FEATURES_ARCH_P (cpu_features, Fast_Unaligned_Load)		\
+   ? OPTIMIZE (sse2_unaligned) : OPTIMIZE (sse2))
+#include "ifunc-vec-c.h"
 
 /* Avoid DWARF definition DIE on ifunc symbol so that GDB can handle
    ifunc symbol properly.  */
 extern __typeof (__redirect_strstr) __libc_strstr;
-libc_ifunc (__libc_strstr,
-	    HAS_ARCH_FEATURE (Fast_Unaligned_Load)
-	    ? __strstr_sse2_unaligned
-	    : __strstr_sse2)
+libc_ifunc (__libc_strstr, IFUNC_SELECTOR ())
 
 #undef strstr
 strong_alias (__libc_strstr, strstr)
@@ -0,0 +1,96 @@
+/* Vector operations for the AVX2 and EVEX memmem and strstr.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <immintrin.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/* The EVEX versions use 256-bit vectors as well, but compare into mask
+   registers, which saves the separate AND and movemask steps.  */
+#define VEC_SIZE 32
+
+typedef __m256i vec_t;
+
+static __always_inline vec_t
+vec_set1 (unsigned char c)
+{
+  return _mm256_set1_epi8 (c);
+}
+
+static __always_inline vec_t
+vec_load (const void *p)
+{
+  return _mm256_load_si256 (p);
+}
+
+static __always_inline vec_t
+vec_loadu (const void *p)
+{
+  return _mm256_loadu_si256 (p);
+}
+
+/* Return a mask with bit I set if byte I of A is equal to byte I of
+   B.  */
+static __always_inline uint32_t
+vec_eq (vec_t a, vec_t b)
+{
+#ifdef USE_EVEX
+  return _mm256_cmpeq_epi8_mask (a, b);
+#else
+  return _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (a, b));
+#endif
+}
+
+/* Return a mask with bit I set if byte I of A is equal to byte I of B
+   and byte I of C is equal to byte I of D.  */
+static __always_inline uint32_t
+vec_eq2 (vec_t a, vec_t b, vec_t c, vec_t d)
+{
+#ifdef USE_EVEX
+  return _mm256_mask_cmpeq_epi8_mask (_mm256_cmpeq_epi8_mask (a, b), c, d);
+#else
+  return _mm256_movemask_epi8 (_mm256_and_si256 (_mm256_cmpeq_epi8 (a, b),
+						 _mm256_cmpeq_epi8 (c, d)));
+#endif
+}
+
+/* Return a mask with bit I set if byte I of A is zero.  */
+static __always_inline uint32_t
+vec_zero (vec_t a)
+{
+#ifdef USE_EVEX
+  return _mm256_testn_epi8_mask (a, a);
+#else
+  return _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (a,
+						  _mm256_setzero_si256 ()));
+#endif
+}
+
+/* Needles longer than this are left to the Two-Way algorithm.  */
+#define VEC_SEARCH_MAX_NEEDLE 256
+
+/* Return true if the candidate verifications done so far, NVERIFY
+   for a needle of length NE_LEN, cost much more than a linear search
+   of the SCANNED bytes of the haystack would.  The vector search then
+   hands the rest of the haystack to the Two-Way algorithm, which
+   has a linear worst case.  */
+static __always_inline bool
+vec_search_too_slow (size_t nverify, size_t ne_len, size_t scanned)
+{
+  return nverify > 16 && nverify * ne_len > 8 * scanned;
+}
@@ -0,0 +1,280 @@
+/* wcscpy, wcpcpy, wcscat, wcsncpy, wcpncpy and wcsncat with AVX2 or EVEX
+   intrinsics.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <immintrin.h>
+#include <libc-pointer-arith.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <wchar.h>
+
+/* The source is read with aligned loads, which cannot cross into an
+   unmapped page, so the string is copied in a single pass instead of
+   computing its length first.  The first vector is rotated with vpermd
+   so that SRC[0] is in element 0.  The first and the last vector are
+   written with masked stores (vpmaskmovd, or a mask register with
+   EVEX), so nothing is written past the terminating null or past N
+   characters.  The vectors in between are written with unaligned
+   stores, four at a time once the source is aligned to four vectors,
+   so that the four loads are in the same page.  SRC must be aligned to
+   wchar_t, as C requires.
+
+   WCSCPY must be defined to the name of the function.  WCSCPY_RTM, if
+   defined, is the name of the version for processors with RTM.  */
+
+#define VEC_SIZE 32
+#define VEC_CHARS (VEC_SIZE / sizeof (wchar_t))
+
+typedef __m256i vec_t;
+
+/* Return a mask with bit I set if character I of V is L'\0'.  */
+static __always_inline uint32_t
+null_mask (vec_t v)
+{
+#ifdef USE_EVEX
+  return _mm256_testn_epi32_mask (v, v);
+#else
+  vec_t eq = _mm256_cmpeq_epi32 (v, _mm256_setzero_si256 ());
+  return _mm256_movemask_ps (_mm256_castsi256_ps (eq));
+#endif
+}
+
+/* If the 4 vectors at P contain no L'\0', copy them to DST and return
+   true.  P must be aligned to 4 vectors.  */
+static __always_inline bool
+copy_4 (wchar_t *dst, const wchar_t *p)
+{
+  const vec_t *vp = (const vec_t *) p;
+  vec_t v0 = _mm256_load_si256 (vp);
+  vec_t v1 = _mm256_load_si256 (vp + 1);
+  vec_t v2 = _mm256_load_si256 (vp + 2);
+  vec_t v3 = _mm256_load_si256 (vp + 3);
+  vec_t min = _mm256_min_epu32 (_mm256_min_epu32 (v0, v1),
+				_mm256_min_epu32 (v2, v3));
+  if (null_mask (min) != 0)
+    return false;
+  vec_t *dp = (vec_t *) dst;
+  _mm256_storeu_si256 (dp, v0);
+  _mm256_storeu_si256 (dp + 1, v1);
+  _mm256_storeu_si256 (dp + 2, v2);
+  _mm256_storeu_si256 (dp + 3, v3);
+  return true;
+}
+
+/* Store the first N characters of V at DST, for N from 1 to
+   VEC_CHARS.  */
+static __always_inline void
+store_n (wchar_t *dst, vec_t v, unsigned int n)
+{
+#ifdef USE_EVEX
+  _mm256_mask_storeu_epi32 (dst, (__mmask8) ((1U << n) - 1), v);
+#else
+  vec_t mask = _mm256_cmpgt_epi32 (_mm256_set1_epi32 (n),
+				   _mm256_setr_epi32 (0, 1, 2, 3,
+						      4, 5, 6, 7));
+  _mm256_maskstore_epi32 ((int *) dst, mask, v);
+#endif
+}
+
+/* Load the aligned vector which contains SRC, with SRC[0] moved to
+   element 0.  Store in *AVAIL the number of characters from SRC up to
+   the end of the vector, and in *NULLS the null mask of these
+   characters.  */
+static __always_inline vec_t
+load_head (const wchar_t *src, unsigned int *avail, uint32_t *nulls)
+{
+  const wchar_t *p = PTR_ALIGN_DOWN (src, VEC_SIZE);
+  unsigned int shift = src - p;
+  vec_t v = _mm256_load_si256 ((const vec_t *) p);
+  *avail = VEC_CHARS - shift;
+  *nulls = null_mask (v) >> shift;
+  vec_t idx = _mm256_add_epi32 (_mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7),
+				_mm256_set1_epi32 (shift));
+  return _mm256_permutevar8x32_epi32 (v, idx);
+}
+
+#if defined USE_AS_WCSNCPY || defined USE_AS_WCPNCPY \
+    || defined USE_AS_WCSNCAT
+/* Copy at most N characters of SRC to DST, and the terminating null if
+   it is among them.  Return the number of characters copied, not
+   counting the null.  */
+static __always_inline size_t
+copy_n (wchar_t *dst, const wchar_t *src, size_t n)
+{
+  if (n == 0)
+    return 0;
+
+  unsigned int avail;
+  uint32_t nulls;
+  vec_t v = load_head (src, &avail, &nulls);
+  if (nulls != 0 && __builtin_ctz (nulls) < n)
+    {
+      unsigned int len = __builtin_ctz (nulls);
+      store_n (dst, v, len + 1);
+      return len;
+    }
+  if (n <= avail)
+    {
+      store_n (dst, v, n);
+      return n;
+    }
+  store_n (dst, v, avail);
+
+  size_t copied = avail;
+  const wchar_t *p = src + avail;
+  while (1)
+    {
+      size_t left = n - copied;
+      if (left > 4 * VEC_CHARS && ((uintptr_t) p & (4 * VEC_SIZE - 1)) == 0
+	  && copy_4 (dst + copied, p))
+	{
+	  copied += 4 * VEC_CHARS;
+	  p += 4 * VEC_CHARS;
+	  continue;
+	}
+
+      v = _mm256_load_si256 ((const vec_t *) p);
+      nulls = null_mask (v);
+      if (nulls != 0 && __builtin_ctz (nulls) < left)
+	{
+	  unsigned int len = __builtin_ctz (nulls);
+	  store_n (dst + copied, v, len + 1);
+	  return copied + len;
+	}
+      if (left <= VEC_CHARS)
+	{
+	  store_n (dst + copied, v, left);
+	  return n;
+	}
+      _mm256_storeu_si256 ((vec_t *) (dst + copied), v);
+      copied += VEC_CHARS;
+      p += VEC_CHARS;
+    }
+}
+#else
+/* Copy SRC and its terminating null to DST.  Return the address of the
+   null in DST.  */
+static __always_inline wchar_t *
+copy (wchar_t *dst, const wchar_t *src)
+{
+  unsigned int avail;
+  uint32_t nulls;
+  vec_t v = load_head (src, &avail, &nulls);
+  if (nulls == 0)
+    {
+      store_n (dst, v, avail);
+      const wchar_t *p = src + avail;
+      dst += avail;
+      while (1)
+	{
+	  if (((uintptr_t) p & (4 * VEC_SIZE - 1)) == 0 && copy_4 (dst, p))
+	    {
+	      p += 4 * VEC_CHARS;
+	      dst += 4 * VEC_CHARS;
+	      continue;
+	    }
+	  v = _mm256_load_si256 ((const vec_t *) p);
+	  nulls = null_mask (v);
+	  if (nulls != 0)
+	    break;
+	  _mm256_storeu_si256 ((vec_t *) dst, v);
+	  p += VEC_CHARS;
+	  dst += VEC_CHARS;
+	}
+    }
+
+  unsigned int len = __builtin_ctz (nulls);
+  store_n (dst, v, len + 1);
+  return dst + len;
+}
+#endif
+
+#if defined USE_AS_WCSNCPY || defined USE_AS_WCPNCPY
+wchar_t *
+WCSCPY (wchar_t *dst, const wchar_t *src, size_t n)
+{
+  size_t len = copy_n (dst, src, n);
+  if (len < n)
+    /* DST[LEN] is the null copied from SRC.  */
+    __wmemset (dst + len + 1, L'\0', n - len - 1);
+# ifdef USE_AS_WCPNCPY
+  return dst + len;
+# else
+  return dst;
+# endif
+}
+#elif defined USE_AS_WCSNCAT
+wchar_t *
+WCSCPY (wchar_t *dst, const wchar_t *src, size_t n)
+{
+  wchar_t *end = dst + __wcslen (dst);
+  end[copy_n (end, src, n)] = L'\0';
+  return dst;
+}
+#else
+wchar_t *
+WCSCPY (wchar_t *dst, const wchar_t *src)
+{
+# if defined USE_AS_WCPCPY
+  return copy (dst, src);
+# elif defined USE_AS_WCSCAT
+  copy (dst + __wcslen (dst), src);
+  return dst;
+# else
+  copy (dst, src);
+  return dst;
+# endif
+}
+#endif
+
+#ifdef WCSCPY_RTM
+# if defined USE_AS_WCPCPY
+#  define WCSCPY_SSE2 __wcpcpy_sse2
+# elif defined USE_AS_WCSCAT
+#  define WCSCPY_SSE2 __wcscat_sse2
+# elif defined USE_AS_WCSNCPY
+#  define WCSCPY_SSE2 __wcsncpy_sse2
+# elif defined USE_AS_WCPNCPY
+#  define WCSCPY_SSE2 __wcpncpy_sse2
+# elif defined USE_AS_WCSNCAT
+#  define WCSCPY_SSE2 __wcsncat_sse2
+# else
+#  define WCSCPY_SSE2 __wcscpy_sse2
+# endif
+
+extern __typeof (WCSCPY) WCSCPY_SSE2 attribute_hidden;
+
+# if defined USE_AS_WCSNCPY || defined USE_AS_WCPNCPY \
+     || defined USE_AS_WCSNCAT
+wchar_t *
+WCSCPY_RTM (wchar_t *dst, const wchar_t *src, size_t n)
+{
+  if (_xtest ())
+    return WCSCPY_SSE2 (dst, src, n);
+  return WCSCPY (dst, src, n);
+}
+# else
+wchar_t *
+WCSCPY_RTM (wchar_t *dst, const wchar_t *src)
+{
+  if (_xtest ())
+    return WCSCPY_SSE2 (dst, src);
+  return WCSCPY (dst, src);
+}
+# endif
+#endif
@@ -26,19 +26,12 @@
 # define SYMBOL_NAME wcscpy
 # include <init-arch.h>
 
-extern __typeof (REDIRECT_NAME) OPTIMIZE (sse2) attribute_hidden;
 extern __typeof (REDIRECT_NAME) OPTIMIZE (ssse3) attribute_hidden;
 
-static inline void *
-IFUNC_SELECTOR (void)
-{
-  const struct cpu_features* cpu_features = __get_cpu_features ();
-
-  if (CPU_FEATURE_USABLE_P (cpu_features, SSSE3))
-    return OPTIMIZE (ssse3);
-
-  return OPTIMIZE (sse2);
-}
+# define IFUNC_VEC_C_FALLBACK						\
+  (CPU_FEATURE_USABLE_P (cpu_features, SSSE3)				\
+   ? OPTIMIZE (ssse3) : OPTIMIZE (sse2))
+# include "ifunc-vec-c.h"
 
 libc_ifunc_redirected (__redirect_wcscpy, __wcscpy, IFUNC_SELECTOR ());
 weak_alias (__wcscpy, wcscpy)
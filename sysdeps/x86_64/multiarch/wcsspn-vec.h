@@ -0,0 +1,131 @@
+/* wcsspn, wcscspn and wcspbrk with AVX2 intrinsics.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <immintrin.h>
+#include <libc-pointer-arith.h>
+#include <stdint.h>
+#include <wchar.h>
+
+/* Wide characters are too large for the bitmap used by strcspn-vec.h.
+   Instead, each vector of 8 characters is compared with every character
+   of the set, which is broadcast from memory.  This takes one
+   comparison per character of the set for 8 characters of the string,
+   where the generic code takes one per character.
+
+   wcscspn and wcspbrk also compare with L'\0', so the search for the
+   first character in the set stops at the end of the string as well.
+   wcsspn searches for the first character not in the set, which
+   includes L'\0'.
+
+   WCSCSPN must be defined to the name of the function.  WCSCSPN_RTM, if
+   defined, is the name of the version for processors with RTM.  */
+
+#define VEC_SIZE 32
+#define VEC_CHARS (VEC_SIZE / sizeof (wchar_t))
+
+typedef __m256i vec_t;
+
+#ifdef USE_AS_WCSPBRK
+# define RETURN(val1, val2) return val1
+#else
+# define RETURN(val1, val2) return val2
+#endif
+
+/* Return a mask with bit I set if character I of V is one of the NSET
+   characters of SET, or L'\0' unless USE_AS_WCSSPN is defined.  */
+static __always_inline uint32_t
+in_set (vec_t v, const wchar_t *set, size_t nset)
+{
+#ifdef USE_AS_WCSSPN
+  vec_t eq = _mm256_setzero_si256 ();
+#else
+  vec_t eq = _mm256_cmpeq_epi32 (v, _mm256_setzero_si256 ());
+#endif
+  /* The comparisons are independent, so the results are combined in a
+     vector register and extracted with a single vmovmskps.  Mask
+     registers would not save an instruction, so there are no EVEX
+     versions.  */
+  for (size_t i = 0; i < nset; i++)
+    eq = _mm256_or_si256 (eq, _mm256_cmpeq_epi32 (v,
+						  _mm256_set1_epi32 (set[i])));
+  return _mm256_movemask_ps (_mm256_castsi256_ps (eq));
+}
+
+#ifdef USE_AS_WCSSPN
+# define STOP(v) (~in_set (v, set, nset) & ((1U << VEC_CHARS) - 1))
+#else
+# define STOP(v) in_set (v, set, nset)
+#endif
+
+#ifdef USE_AS_WCSPBRK
+wchar_t *
+#else
+size_t
+#endif
+WCSCSPN (const wchar_t *s, const wchar_t *set)
+{
+  size_t nset = __wcslen (set);
+#ifdef USE_AS_WCSSPN
+  if (nset == 0)
+    return 0;
+#endif
+
+  /* Aligned loads cannot cross into an unmapped page.  The characters
+     before S in the first vector are shifted out of the mask.  */
+  const wchar_t *p = PTR_ALIGN_DOWN (s, VEC_SIZE);
+  uint32_t stop = STOP (_mm256_load_si256 ((const vec_t *) p)) >> (s - p);
+  if (stop != 0)
+    p = s + __builtin_ctz (stop);
+  else
+    while (1)
+      {
+	p += VEC_CHARS;
+	stop = STOP (_mm256_load_si256 ((const vec_t *) p));
+	if (stop != 0)
+	  {
+	    p += __builtin_ctz (stop);
+	    break;
+	  }
+      }
+
+  RETURN (*p != L'\0' ? (wchar_t *) p : NULL, p - s);
+}
+
+#ifdef WCSCSPN_RTM
+# if defined USE_AS_WCSPBRK
+#  define WCSCSPN_SSE2 __wcspbrk_sse2
+# elif defined USE_AS_WCSSPN
+#  define WCSCSPN_SSE2 __wcsspn_sse2
+# else
+#  define WCSCSPN_SSE2 __wcscspn_sse2
+# endif
+
+extern __typeof (WCSCSPN) WCSCSPN_SSE2 attribute_hidden;
+
+# ifdef USE_AS_WCSPBRK
+wchar_t *
+# else
+size_t
+# endif
+WCSCSPN_RTM (const wchar_t *s, const wchar_t *set)
+{
+  if (_xtest ())
+    return WCSCSPN_SSE2 (s, set);
+  return WCSCSPN (s, set);
+}
+#endif
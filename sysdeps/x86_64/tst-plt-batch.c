@@ -0,0 +1,97 @@
+/* Test the batched resolution of lazy PLT slots.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <link.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/xdlfcn.h>
+
+#define R_SYM(info) _ElfW (ELF, __ELF_NATIVE_CLASS, R_SYM) (info)
+
+/* Return the GOT entry of the PLT slot for the symbol NAME in MAP.  */
+static ElfW(Addr)
+plt_slot (struct link_map *map, const char *name)
+{
+  const ElfW(Sym) *symtab = NULL;
+  const char *strtab = NULL;
+  const ElfW(Rela) *jmprel = NULL;
+  size_t pltrelsz = 0;
+  for (const ElfW(Dyn) *d = map->l_ld; d->d_tag != DT_NULL; ++d)
+    switch (d->d_tag)
+      {
+      case DT_SYMTAB:
+	symtab = (const void *) d->d_un.d_ptr;
+	break;
+      case DT_STRTAB:
+	strtab = (const void *) d->d_un.d_ptr;
+	break;
+      case DT_JMPREL:
+	jmprel = (const void *) d->d_un.d_ptr;
+	break;
+      case DT_PLTRELSZ:
+	pltrelsz = d->d_un.d_val;
+	break;
+      }
+  TEST_VERIFY_EXIT (symtab != NULL && strtab != NULL && jmprel != NULL);
+
+  for (size_t i = 0; i < pltrelsz / sizeof (*jmprel); ++i)
+    {
+      const ElfW(Sym) *sym = &symtab[R_SYM (jmprel[i].r_info)];
+      if (strcmp (strtab + sym->st_name, name) == 0)
+	return *(ElfW(Addr) *) (map->l_addr + jmprel[i].r_offset);
+    }
+  FAIL_EXIT1 ("%s: no PLT slot for %s", map->l_name, name);
+}
+
+static int
+do_test (void)
+{
+  void *mod = xdlopen ("tst-plt-batchmod.so", RTLD_LAZY);
+  void *dep = xdlopen ("tst-plt-batchmod-dep.so", RTLD_LAZY);
+  struct link_map *map;
+  TEST_COMPARE (dlinfo (mod, RTLD_DI_LINKMAP, &map), 0);
+
+  ElfW(Addr) f1 = (ElfW(Addr)) xdlsym (dep, "f1");
+  ElfW(Addr) f2 = (ElfW(Addr)) xdlsym (dep, "f2");
+  ElfW(Addr) f3 = (ElfW(Addr)) xdlsym (dep, "f3");
+  ElfW(Addr) getppid_slot = plt_slot (map, "getppid");
+
+  /* Nothing has been resolved yet.  */
+  TEST_VERIFY (plt_slot (map, "f1") != f1);
+  TEST_VERIFY (plt_slot (map, "f2") != f2);
+  TEST_VERIFY (plt_slot (map, "f3") != f3);
+
+  /* The first call resolves all the functions from the same object,
+     but not those from libc.  */
+  int (*call_f1) (void) = xdlsym (mod, "call_f1");
+  TEST_COMPARE (call_f1 (), 1);
+  TEST_VERIFY (plt_slot (map, "f1") == f1);
+  TEST_VERIFY (plt_slot (map, "f2") == f2);
+  TEST_VERIFY (plt_slot (map, "f3") == f3);
+  TEST_VERIFY (plt_slot (map, "getppid") == getppid_slot);
+
+  int (*call_f2_f3) (void) = xdlsym (mod, "call_f2_f3");
+  TEST_COMPARE (call_f2_f3 (), 5);
+
+  xdlclose (dep);
+  xdlclose (mod);
+  return 0;
+}
+
+#include <support/test-driver.c>
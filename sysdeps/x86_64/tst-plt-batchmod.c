@@ -0,0 +1,41 @@
+/* Module with several lazy PLT slots for tst-plt-batch.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <unistd.h>
+
+extern int f1 (void);
+extern int f2 (void);
+extern int f3 (void);
+
+int
+call_f1 (void)
+{
+  return f1 ();
+}
+
+int
+call_f2_f3 (void)
+{
+  return f2 () + f3 ();
+}
+
+int
+call_getppid (void)
+{
+  return getppid ();
+}
@@ -0,0 +1,70 @@
+/* Test lazy binding of a sibling call with vector arguments.
+   Copyright (C) 2021 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* tst-plt-sibcallmod.so forwards its double arguments with a jump to
+   the PLT and so only uses general purpose instructions, as its
+   GNU_PROPERTY_X86_FEATURE_2_USED property says.  The lazy binding
+   trampoline must still preserve the vector registers for it.  */
+
+#include <stdio.h>
+#include <support/check.h>
+#include <support/xdlfcn.h>
+
+static double received[8];
+
+/* Called through the PLT of tst-plt-sibcallmod.so.  */
+void
+store8 (double a, double b, double c, double d, double e, double f,
+	double g, double h)
+{
+  received[0] = a;
+  received[1] = b;
+  received[2] = c;
+  received[3] = d;
+  received[4] = e;
+  received[5] = f;
+  received[6] = g;
+  received[7] = h;
+}
+
+static int
+do_test (void)
+{
+  void *handle = xdlopen ("tst-plt-sibcallmod.so", RTLD_LAZY);
+  void (*forward8) (double, double, double, double, double, double,
+		    double, double) = xdlsym (handle, "forward8");
+
+  /* The first call goes through the lazy binding trampoline, the
+     second one directly to store8.  */
+  for (int i = 0; i < 2; i++)
+    {
+      forward8 (0.5, 1.5, 2.5, 3.5, 4.5, 5.5, 6.5, 7.5);
+      for (int j = 0; j < 8; j++)
+	if (received[j] != j + 0.5)
+	  {
+	    support_record_failure ();
+	    printf ("error: call %d: argument %d is %a instead of %a\n",
+		    i, j, received[j], j + 0.5);
+	  }
+    }
+
+  xdlclose (handle);
+  return 0;
+}
+
+#include <support/test-driver.c>
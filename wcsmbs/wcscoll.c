@@ -22,6 +22,7 @@
 #define USTRING_TYPE wint_t
 #define STRCOLL __wcscoll
 #define STRCOLL_L __wcscoll_l
+#define STRCMP __wcscmp
 #define USE_HIDDEN_DEF
 
 #include "../string/strcoll.c"